@@ -5,197 +5,1422 @@
 #include <map>
 #include <ctime>
 #include <cstdlib>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "lr6-output.h"
+#include "lr6-profile.h"
 
 using namespace std;
 
-// функция для создания матрицы и заполнения ее случайными числами в заданном диапазоне
-vector<vector<int>> createMatrix(int rows, int cols, int minVal, int maxVal) {
-    vector<vector<int>> matrix(rows, vector<int>(cols)); // создаем матрицу из векторов, размером rows x cols
-    for (int i = 0; i < rows; ++i) { // цикл по строкам
-        for (int j = 0; j < cols; ++j) { // цикл по столбцам
-            matrix[i][j] = rand() % (maxVal - minVal + 1) + minVal; // заполняем элемент случайным числом в диапазоне
+// арена памяти: матрицы берут память подряд из больших блоков и освобождаются все сразу
+class MatrixArena {
+public:
+    // размер блока по умолчанию - 64 мб
+    explicit MatrixArena(size_t blockSize = size_t(64) << 20) : blockSize(blockSize) {}
+
+    // выделение bytes байт с выравниванием по строке кэша
+    void* allocate(size_t bytes) {
+        const size_t alignment = 64;
+        size_t offset = (used + alignment - 1) / alignment * alignment;
+        if (blocks.empty() || offset + bytes > capacity) {
+            // текущий блок закончился - заводим новый (не меньше запроса)
+            capacity = max(blockSize, bytes);
+            blocks.emplace_back(static_cast<char*>(::operator new(capacity, align_val_t(alignment))));
+            offset = 0;
         }
+        used = offset + bytes;
+        return blocks.back().get() + offset;
+    }
+
+    // освобождение всех матриц арены
+    void reset() {
+        blocks.clear();
+        used = capacity = 0;
+    }
+
+private:
+    // удаление блока с тем же выравниванием, с которым он создан
+    struct BlockDeleter {
+        void operator()(char* block) const { ::operator delete(block, align_val_t(64)); }
+    };
+
+    size_t blockSize;                                 // размер нового блока
+    size_t used = 0;                                  // занято в последнем блоке
+    size_t capacity = 0;                              // размер последнего блока
+    vector<unique_ptr<char, BlockDeleter>> blocks;    // все блоки арены
+};
+
+// матрица целых чисел в одном непрерывном блоке по строкам;
+// строки начинаются с шагом stride элементов, выровненным по строке кэша
+struct IntMatrix {
+    int rows = 0;        // количество строк
+    int cols = 0;        // количество столбцов
+    int stride = 0;      // шаг между началами строк (в элементах)
+    int* data = nullptr; // начало первой строки
+
+    // указатель на начало строки i
+    int* row(int i) { return data + size_t(i) * stride; }
+    const int* row(int i) const { return data + size_t(i) * stride; }
+
+    // элемент (i, j)
+    int& operator()(int i, int j) { return data[size_t(i) * stride + j]; }
+    int operator()(int i, int j) const { return data[size_t(i) * stride + j]; }
+};
+
+// выделение матрицы rows x cols из арены
+IntMatrix allocateMatrix(MatrixArena& arena, int rows, int cols) {
+    IntMatrix matrix;
+    matrix.rows = rows;
+    matrix.cols = cols;
+    // 16 элементов int занимают ровно строку кэша
+    matrix.stride = (cols + 15) / 16 * 16;
+    matrix.data = static_cast<int*>(arena.allocate(size_t(rows) * matrix.stride * sizeof(int)));
+    return matrix;
+}
+
+// хеш splitmix64: из seed и номера потока получаем независимое начальное состояние
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// генератор xoshiro256**: быстрый, с маленьким состоянием, у каждого потока свой экземпляр
+struct Xoshiro256 {
+    uint64_t s[4];
+
+    // независимый поток stream для заданного seed (например, номер строки матрицы)
+    Xoshiro256(uint64_t seed, uint64_t stream) {
+        uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+        for (auto& word : s) word = splitMix64(state);
     }
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // следующее 64-битное число
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // равномерное число от 0 до range - 1 без смещения (метод лемира), range <= 2^32
+    uint32_t below(uint64_t range) {
+        uint32_t x = uint32_t(next() >> 32);
+        if (range > UINT32_MAX) return x;
+        uint64_t product = uint64_t(x) * range;
+        uint32_t low = uint32_t(product);
+        if (low < range) {
+            // отбрасываем значения, дающие смещение
+            uint32_t threshold = uint32_t(-uint32_t(range)) % uint32_t(range);
+            while (low < threshold) {
+                x = uint32_t(next() >> 32);
+                product = uint64_t(x) * range;
+                low = uint32_t(product);
+            }
+        }
+        return uint32_t(product >> 32);
+    }
+
+    // равномерное число в диапазоне [minVal, maxVal]
+    int between(int minVal, int maxVal) {
+        return int(int64_t(minVal) + below(uint64_t(int64_t(maxVal) - minVal + 1)));
+    }
+};
+
+// запуск worker(index) в threadCount потоках (index = 0 выполняется в текущем) с ожиданием всех
+template <typename Worker>
+void runOnThreads(int threadCount, Worker worker) {
+    // зоны профиля в потоках показываются под зоной, запустившей потоки
+    LR6_PROFILE_PARENT(parentZones);
+    vector<thread> threads;
+    for (int index = 1; index < threadCount; ++index) {
+        threads.emplace_back([&, index] {
+            LR6_PROFILE_ATTACH(parentZones);
+            worker(index);
+        });
+    }
+    worker(0);
+    if (!threads.empty()) {
+        LR6_PROFILE_ZONE("ожидание потоков");
+        for (auto& t : threads) t.join();
+    }
+}
+
+// число потоков для обработки items независимых частей (0 - по числу ядер)
+int resolveThreadCount(int threadCount, int64_t items) {
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    return int(max<int64_t>(1, min<int64_t>(threadCount, items)));
+}
+
+// заполнение строк матрицы случайными числами в заданном диапазоне; строка с глобальным
+// номером firstRowIndex + i заполняется собственным потоком генератора (seed, номер строки),
+// поэтому результат зависит только от seed и не зависит от числа потоков и разбиения на части
+void fillRandomRows(IntMatrix& matrix, int64_t firstRowIndex, int minVal, int maxVal,
+                    uint64_t seed, int threadCount = 0) {
+    int rows = matrix.rows;
+    threadCount = resolveThreadCount(threadCount, rows);
+
+    // каждый поток заполняет свой диапазон строк
+    auto fillRows = [&](int index) {
+        int firstRow = int(int64_t(rows) * index / threadCount);
+        int lastRow = int(int64_t(rows) * (index + 1) / threadCount);
+        for (int i = firstRow; i < lastRow; ++i) { // цикл по строкам
+            Xoshiro256 generator(seed, firstRowIndex + i); // генератор строки
+            int* row = matrix.row(i); // начало текущей строки
+            for (int j = 0; j < matrix.cols; ++j) { // цикл по столбцам
+                row[j] = generator.between(minVal, maxVal); // заполняем элемент случайным числом в диапазоне
+            }
+        }
+    };
+    runOnThreads(threadCount, fillRows);
+}
+
+// функция для создания матрицы и заполнения ее случайными числами в заданном диапазоне
+IntMatrix createMatrix(MatrixArena& arena, int rows, int cols, int minVal, int maxVal,
+                       uint64_t seed, int threadCount = 0) {
+    IntMatrix matrix = allocateMatrix(arena, rows, cols); // одна непрерывная область памяти под всю матрицу
+    fillRandomRows(matrix, 0, minVal, maxVal, seed, threadCount);
     return matrix; // возвращаем заполненную матрицу
 }
 
-// функция для вывода матрицы на экран
-void printMatrix(const vector<vector<int>>& matrix) {
-    for (const auto& row : matrix) { // перебираем каждую строку матрицы
-        for (int val : row) { // перебираем элементы строки
-            cout << val << " "; // выводим элемент с пробелом
+// сигнатура двоичного файла матрицы: заголовок, затем rows и cols (uint64),
+// затем rows*cols чисел int32 по строкам в порядке little-endian
+const char binaryMatrixMagic[8] = {'L', 'R', '6', 'I', 'M', 'A', 'T', '\0'};
+
+// функция для вывода матрицы на экран; binary - двоичный дамп в формате файла матрицы
+void printMatrix(const IntMatrix& matrix, bool binary = false) {
+    OutputBuffer out(cout); // числа копятся в буфере и выводятся большими частями
+    if (binary) {
+        writeBinaryMatrixHeader(out, binaryMatrixMagic, uint64_t(matrix.rows), uint64_t(matrix.cols));
+        for (int i = 0; i < matrix.rows; ++i) out.writeRaw(matrix.row(i), size_t(matrix.cols) * sizeof(int));
+        return;
+    }
+    for (int i = 0; i < matrix.rows; ++i) { // перебираем каждую строку матрицы
+        const int* row = matrix.row(i);
+        for (int j = 0; j < matrix.cols; ++j) { // перебираем элементы строки
+            out.writeInteger(row[j]); // выводим элемент с пробелом
+            out.put(' ');
         }
-        cout << endl; // перевод строки после каждой строки матрицы
+        out.put('\n'); // перевод строки без сброса потока
     }
 }
 
-// функция для графического вывода шахматной доски
-void printChessBoard(const pair<int, int>& kingPos, const vector<pair<int, int>>& queens, const vector<pair<int, int>>& knights) {
-    // Символы для фигур
-    const char* king = "K";
-    const char* queen = "Q";
-    const char* knight = "H";
-    const char* empty = "·";
-    
-    cout << "  a b c d e f g h" << endl;
-
-    for (int i = 0; i < 8; ++i) {
-        // вывод номера строки (от 8 до 1)
-        cout << 8 - i << " ";
-        for (int j = 0; j < 8; ++j) {
-            // проверка, есть ли на текущей позиции король
-            bool isKing = (i == kingPos.first && j == kingPos.second);
-            // флаги для ферзя и коня
-            bool isQueen = false;
-            bool isKnight = false;
-            
-            // проверка наличия ферзя на текущей позиции
-            for (const auto& q : queens) {
-                if (i == q.first && j == q.second) {
-                    isQueen = true;
-                    break;
+// битовая доска: бит row * 8 + col соответствует клетке (row, col), строка 0 - восьмая горизонталь
+typedef uint64_t Bitboard;
+
+// номер клетки по координатам
+inline int squareIndex(int row, int col) { return row * 8 + col; }
+
+// битовая доска из одной клетки
+inline Bitboard squareBit(int square) { return Bitboard(1) << square; }
+
+// предвычисленные таблицы атак для доски 8x8
+struct AttackTables {
+    Bitboard knight[64];      // клетки, атакуемые конем с данной клетки
+    Bitboard queen[64];       // лучи ферзя с данной клетки на пустой доске
+    Bitboard between[64][64]; // клетки строго между двумя клетками одной линии (иначе 0)
+};
+
+// построение таблиц (один раз при первом обращении)
+const AttackTables& attackTables() {
+    static const AttackTables tables = [] {
+        AttackTables t = {};
+        const int knightSteps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+        const int queenSteps[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+        for (int row = 0; row < 8; ++row) {
+            for (int col = 0; col < 8; ++col) {
+                int from = squareIndex(row, col);
+                for (const auto& step : knightSteps) {
+                    int r = row + step[0], c = col + step[1];
+                    if (r >= 0 && r < 8 && c >= 0 && c < 8) t.knight[from] |= squareBit(squareIndex(r, c));
                 }
-            }
-            
-            // проверка наличия коня на текущей позиции
-            for (const auto& k : knights) {
-                if (i == k.first && j == k.second) {
-                    isKnight = true;
-                    break;
+                // идем по каждому лучу, запоминая пройденные клетки как "между"
+                for (const auto& step : queenSteps) {
+                    Bitboard passed = 0;
+                    for (int r = row + step[0], c = col + step[1]; r >= 0 && r < 8 && c >= 0 && c < 8;
+                         r += step[0], c += step[1]) {
+                        int to = squareIndex(r, c);
+                        t.queen[from] |= squareBit(to);
+                        t.between[from][to] = passed;
+                        passed |= squareBit(to);
+                    }
                 }
             }
-            
-            // вывод фигуры или клетки
-            if (isKing) {
-                cout << king << " ";
-            } else if (isQueen) {
-                cout << queen << " ";
-            } else if (isKnight) {
-                cout << knight << " ";
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// позиция в виде битовых досок
+struct BitboardPosition {
+    int kingSquare = 0;  // клетка короля
+    Bitboard queens = 0; // клетки ферзей
+    Bitboard knights = 0; // клетки коней
+
+    // все занятые клетки
+    Bitboard occupied() const { return queens | knights | squareBit(kingSquare); }
+};
+
+// перевод позиции из списков координат
+BitboardPosition makeBitboardPosition(const pair<int, int>& kingPos,
+                                      const vector<pair<int, int>>& queens,
+                                      const vector<pair<int, int>>& knights) {
+    BitboardPosition position;
+    position.kingSquare = squareIndex(kingPos.first, kingPos.second);
+    for (const auto& q : queens) position.queens |= squareBit(squareIndex(q.first, q.second));
+    for (const auto& k : knights) position.knights |= squareBit(squareIndex(k.first, k.second));
+    return position;
+}
+
+// атакует ли ферзь с клетки queenSquare клетку target: одна линия и пустые клетки между ними
+inline bool queenAttacksSquare(int queenSquare, int target, Bitboard occupied) {
+    const AttackTables& tables = attackTables();
+    return (tables.queen[queenSquare] & squareBit(target)) && !(tables.between[queenSquare][target] & occupied);
+}
+
+// все ферзи, атакующие короля
+inline Bitboard queensAttackingKing(const BitboardPosition& position) {
+    const AttackTables& tables = attackTables();
+    // кандидаты - ферзи на линиях короля, затем проверка пустоты между ними
+    Bitboard candidates = position.queens & tables.queen[position.kingSquare];
+    Bitboard occupied = position.occupied();
+    Bitboard attackers = 0;
+    while (candidates) {
+        int square = __builtin_ctzll(candidates);
+        if (!(tables.between[square][position.kingSquare] & occupied)) attackers |= squareBit(square);
+        candidates &= candidates - 1;
+    }
+    return attackers;
+}
+
+// все кони, атакующие короля: ход коня симметричен, поэтому достаточно таблицы для клетки короля
+inline Bitboard knightsAttackingKing(const BitboardPosition& position) {
+    return position.knights & attackTables().knight[position.kingSquare];
+}
+
+// доска произвольного размера size x size: клетка (row, col) имеет номер row * size + col,
+// строка 0 - верхняя горизонталь с номером size
+
+// фигура на клетке
+enum class Piece : uint8_t { None, King, Queen, Knight };
+
+// направления лучей ферзя (строка, столбец)
+const int rayDirections[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+
+// предвычисленные таблицы для доски одного размера
+struct BoardTables {
+    int size = 0;                  // сторона доски
+    int rayStep[8] = {};           // шаг номера клетки вдоль каждого направления
+    vector<int> rayLength;         // число клеток до края: [клетка * 8 + направление]
+    vector<int> knightStart;       // начало списка ходов коня клетки в knightTargets (size * size + 1)
+    vector<int> knightTargets;     // клетки, атакуемые конем, подряд для всех клеток
+};
+
+// построение таблиц для доски size x size
+BoardTables buildBoardTables(int size) {
+    BoardTables tables;
+    tables.size = size;
+    int squares = size * size;
+    for (int d = 0; d < 8; ++d) tables.rayStep[d] = rayDirections[d][0] * size + rayDirections[d][1];
+    tables.rayLength.resize(size_t(squares) * 8);
+    tables.knightStart.reserve(squares + 1);
+    const int knightSteps[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            int square = row * size + col;
+            for (int d = 0; d < 8; ++d) {
+                // сколько шагов можно сделать по строке и по столбцу до края
+                int dr = rayDirections[d][0], dc = rayDirections[d][1];
+                int byRow = dr > 0 ? size - 1 - row : dr < 0 ? row : size;
+                int byCol = dc > 0 ? size - 1 - col : dc < 0 ? col : size;
+                tables.rayLength[size_t(square) * 8 + d] = min(byRow, byCol);
+            }
+            tables.knightStart.push_back(int(tables.knightTargets.size()));
+            for (const auto& step : knightSteps) {
+                int r = row + step[0], c = col + step[1];
+                if (r >= 0 && r < size && c >= 0 && c < size) tables.knightTargets.push_back(r * size + c);
+            }
+        }
+    }
+    tables.knightStart.push_back(int(tables.knightTargets.size()));
+    return tables;
+}
+
+// таблицы для доски size x size: строятся один раз на каждый размер
+const BoardTables& boardTables(int size) {
+    static mutex guard;
+    static map<int, unique_ptr<BoardTables>> cache;
+    lock_guard<mutex> lock(guard);
+    auto& tables = cache[size];
+    if (!tables) tables = make_unique<BoardTables>(buildBoardTables(size));
+    return *tables;
+}
+
+// позиция на доске size x size с любым числом ферзей и коней
+struct BoardPosition {
+    int size = 8;          // сторона доски
+    int kingSquare = 0;    // клетка короля
+    vector<int> queens;    // клетки ферзей
+    vector<int> knights;   // клетки коней
+    vector<Piece> cells;   // фигура на каждой клетке (size * size)
+
+    explicit BoardPosition(int size = 8) : size(size), cells(size_t(size) * size, Piece::None) {}
+
+    // постановка фигуры на клетку
+    void place(int square, Piece piece) {
+        cells[square] = piece;
+        if (piece == Piece::King) kingSquare = square;
+        if (piece == Piece::Queen) queens.push_back(square);
+        if (piece == Piece::Knight) knights.push_back(square);
+    }
+};
+
+// ферзи, атакующие короля: по каждому лучу от короля идем до первой занятой клетки,
+// поэтому стоимость зависит от размера доски, а не от числа фигур
+vector<int> findQueenAttackers(const BoardPosition& position) {
+    const BoardTables& tables = boardTables(position.size);
+    vector<int> attackers;
+    for (int d = 0; d < 8; ++d) {
+        int square = position.kingSquare;
+        for (int steps = tables.rayLength[size_t(position.kingSquare) * 8 + d]; steps > 0; --steps) {
+            square += tables.rayStep[d];
+            if (position.cells[square] == Piece::None) continue;
+            if (position.cells[square] == Piece::Queen) attackers.push_back(square);
+            break; // первая фигура на луче закрывает все следующие
+        }
+    }
+    return attackers;
+}
+
+// кони, атакующие короля: ход коня симметричен, проверяем клетки хода коня от короля
+vector<int> findKnightAttackers(const BoardPosition& position) {
+    const BoardTables& tables = boardTables(position.size);
+    vector<int> attackers;
+    for (int i = tables.knightStart[position.kingSquare]; i < tables.knightStart[position.kingSquare + 1]; ++i) {
+        int square = tables.knightTargets[i];
+        if (position.cells[square] == Piece::Knight) attackers.push_back(square);
+    }
+    return attackers;
+}
+
+// случайная позиция: король, queenCount ферзей и knightCount коней на различных клетках
+BoardPosition randomBoardPosition(int size, int queenCount, int knightCount, Xoshiro256& rng) {
+    BoardPosition position(size);
+    // свободная клетка: повтор, пока не попадем на пустую
+    auto freeSquare = [&] {
+        int square;
+        do {
+            square = int(rng.below(uint64_t(size) * size));
+        } while (position.cells[square] != Piece::None);
+        return square;
+    };
+    position.place(freeSquare(), Piece::King);
+    for (int i = 0; i < queenCount; ++i) position.place(freeSquare(), Piece::Queen);
+    for (int i = 0; i < knightCount; ++i) position.place(freeSquare(), Piece::Knight);
+    return position;
+}
+
+// название клетки: столбцы буквами (a..z, затем aa, ab, ...), строки числами от size до 1
+string squareName(int size, int square) {
+    int row = square / size, col = square % size;
+    string column;
+    for (int c = col + 1; c > 0; c = (c - 1) / 26) column.insert(column.begin(), char('a' + (c - 1) % 26));
+    return column + to_string(size - row);
+}
+
+// графический вывод доски произвольного размера (до 26 столбцов - по одной букве)
+void printBoard(const BoardPosition& position) {
+    // Символы для фигур
+    const char* symbols[] = {"·", "K", "Q", "H"};
+    const char* empty = symbols[0];
+    const char* lightEmpty = "\033[48;5;7m·\033[0m"; // светлая клетка с фоном
+    int size = position.size;
+    int width = int(to_string(size).size()); // ширина номера строки
+
+    // заголовок с буквенными обозначениями столбцов
+    string header(width + 1, ' ');
+    for (int j = 0; j < size; ++j) header += string(1, char('a' + j)) + (j + 1 < size ? " " : "");
+    header += '\n';
+
+    // вся доска собирается в буфере и выводится одной записью
+    OutputBuffer out(cout);
+    out.write(header);
+    for (int i = 0; i < size; ++i) {
+        // вывод номера строки (от size до 1)
+        out.writeInteger(size - i, width);
+        out.put(' ');
+        for (int j = 0; j < size; ++j) {
+            Piece piece = position.cells[size_t(i) * size + j];
+            if (piece != Piece::None) {
+                out.write(symbols[int(piece)]);
             } else {
                 // чередование цветов клеток (светлая и тёмная)
-                if ((i + j) % 2 == 0) {
-                    // светлая клетка с фоном
-                    cout << "\033[48;5;7m" << empty << "\033[0m" << " ";
-                } else {
-                    // тёмная клетка без фона
-                    cout << empty << " ";
-                }
+                out.write((i + j) % 2 == 0 ? lightEmpty : empty);
             }
+            out.put(' ');
         }
         // вывод номера строки в конце строки
-        cout << 8 - i << endl;
+        out.writeInteger(size - i);
+        out.put('\n');
     }
     // повторный вывод заголовка с буквенными обозначениями
-    cout << "  a b c d e f g h" << endl;
-}
-
-// функция для поиска возрастающей последовательности с минимальным начальным элементом в строках матрицы
-vector<int> findIncreasingSequence(const vector<vector<int>>& matrix) {
-    vector<int> result; // вектор для хранения найденной последовательности
-    int minStart = 101; // начальное значение больше максимального возможного элемента 
-
-    for (const auto& row : matrix) { // перебираем каждую строку матрицы
-        for (int i = 0; i < row.size(); ++i) { // перебираем каждый элемент строки
-            vector<int> currentSeq = {row[i]}; // начинаем новую последовательность с текущего элемента
-            for (int j = i + 1; j < row.size(); ++j) { // ищем продолжение последовательности
-                if (row[j] > currentSeq.back()) { // если следующий элемент больше последнего в текущей последовательности
-                    currentSeq.push_back(row[j]); // добавляем его в последовательность
-                } else {
-                    break; // если не больше, прерываем поиск для этой стартовой точки
+    out.write(header);
+}
+
+// функция для графического вывода шахматной доски 8x8
+void printChessBoard(const pair<int, int>& kingPos, const vector<pair<int, int>>& queens, const vector<pair<int, int>>& knights) {
+    BoardPosition position(8);
+    position.place(kingPos.first * 8 + kingPos.second, Piece::King);
+    for (const auto& q : queens) position.place(q.first * 8 + q.second, Piece::Queen);
+    for (const auto& k : knights) position.place(k.first * 8 + k.second, Piece::Knight);
+    printBoard(position);
+}
+
+// строго возрастающая серия в строке матрицы
+struct IncreasingRun {
+    int row = -1;       // номер строки (-1 - серия не найдена)
+    int start = 0;      // индекс первого элемента
+    int length = 0;     // длина серии
+    int firstValue = 0; // первый элемент серии
+};
+
+// серия a лучше серии b: меньший первый элемент, при равенстве - более ранняя строка
+bool isBetterRun(const IncreasingRun& a, const IncreasingRun& b) {
+    if (a.row < 0) return false;
+    if (b.row < 0) return true;
+    return a.firstValue < b.firstValue || (a.firstValue == b.firstValue && a.row < b.row);
+}
+
+// поиск в строке за один проход: любая возрастающая последовательность с минимальным началом -
+// это начало максимальной серии, поэтому достаточно следить за началом текущей серии
+IncreasingRun findBestRunInRowScalar(const int* row, int cols, int rowIndex) {
+    IncreasingRun best;
+    int runStart = 0; // начало текущей серии
+    for (int j = 1; j <= cols; ++j) {
+        // серия [runStart, j) закончилась на конце строки или на невозрастании
+        if (j == cols || row[j] <= row[j - 1]) {
+            // при равных началах остается более ранняя серия
+            if (j - runStart > 1 && (best.row < 0 || row[runStart] < best.firstValue)) {
+                best.row = rowIndex;
+                best.start = runStart;
+                best.length = j - runStart;
+                best.firstValue = row[runStart];
+            }
+            runStart = j;
+        }
+    }
+    return best;
+}
+
+// серия, начинающаяся в start (start должен быть началом серии длиной не меньше 2)
+inline IncreasingRun completeRun(const int* row, int cols, int rowIndex, int start) {
+    int end = start + 1;
+    while (end < cols && row[end] > row[end - 1]) ++end;
+    IncreasingRun run;
+    run.row = rowIndex;
+    run.start = start;
+    run.length = end - start;
+    run.firstValue = row[start];
+    return run;
+}
+
+// позиция p - начало серии длиной не меньше 2: row[p] <= row[p-1] (или p == 0) и row[p+1] > row[p];
+// векторные варианты ищут минимум row[p] среди таких позиций без ветвлений,
+// затем находят первую позицию с этим значением и досчитывают длину серии
+inline bool isRunStart(const int* row, int p) {
+    return (p == 0 || row[p] <= row[p - 1]) && row[p + 1] > row[p];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// avx2: 8 позиций за раз
+__attribute__((target("avx2")))
+IncreasingRun findBestRunInRowAvx2(const int* row, int cols, int rowIndex) {
+    if (cols < 2) return IncreasingRun();
+    // позиция 0 не имеет левого соседа
+    int minValue = row[1] > row[0] ? row[0] : INT32_MAX;
+    __m256i sentinel = _mm256_set1_epi32(INT32_MAX);
+    __m256i minimum = sentinel;
+    int p = 1;
+    for (; p + 9 <= cols; p += 8) {
+        __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p - 1));
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p + 1));
+        // начало серии: не больше предыдущего и меньше следующего
+        __m256i starts = _mm256_andnot_si256(_mm256_cmpgt_epi32(current, previous),
+                                             _mm256_cmpgt_epi32(next, current));
+        minimum = _mm256_min_epi32(minimum, _mm256_blendv_epi8(sentinel, current, starts));
+    }
+    // горизонтальный минимум и скалярный хвост
+    alignas(32) int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), minimum);
+    for (int value : lanes) minValue = min(minValue, value);
+    for (; p + 1 < cols; ++p) {
+        if (isRunStart(row, p)) minValue = min(minValue, row[p]);
+    }
+    // начало серии не может быть максимальным int: за ним идет больший элемент
+    if (minValue == INT32_MAX) return IncreasingRun();
+
+    // первая позиция начала серии с найденным значением
+    if (row[1] > row[0] && row[0] == minValue) return completeRun(row, cols, rowIndex, 0);
+    __m256i target = _mm256_set1_epi32(minValue);
+    for (p = 1; p + 9 <= cols; p += 8) {
+        __m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p - 1));
+        __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + p + 1));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi32(current, target),
+                                        _mm256_andnot_si256(_mm256_cmpgt_epi32(current, previous),
+                                                            _mm256_cmpgt_epi32(next, current)));
+        uint32_t mask = _mm256_movemask_ps(_mm256_castsi256_ps(hits));
+        if (mask) return completeRun(row, cols, rowIndex, p + __builtin_ctz(mask));
+    }
+    for (; p + 1 < cols; ++p) {
+        if (row[p] == minValue && isRunStart(row, p)) return completeRun(row, cols, rowIndex, p);
+    }
+    return IncreasingRun();
+}
+
+// avx-512: 16 позиций за раз, маски сравнения получаются сразу
+__attribute__((target("avx512f")))
+IncreasingRun findBestRunInRowAvx512(const int* row, int cols, int rowIndex) {
+    if (cols < 2) return IncreasingRun();
+    int minValue = row[1] > row[0] ? row[0] : INT32_MAX;
+    __m512i minimum = _mm512_set1_epi32(INT32_MAX);
+    int p = 1;
+    for (; p + 17 <= cols; p += 16) {
+        __m512i previous = _mm512_loadu_si512(row + p - 1);
+        __m512i current = _mm512_loadu_si512(row + p);
+        __m512i next = _mm512_loadu_si512(row + p + 1);
+        __mmask16 starts = _mm512_cmple_epi32_mask(current, previous) &
+                           _mm512_cmpgt_epi32_mask(next, current);
+        minimum = _mm512_mask_min_epi32(minimum, starts, minimum, current);
+    }
+    alignas(64) int lanes[16];
+    _mm512_store_si512(lanes, minimum);
+    for (int value : lanes) minValue = min(minValue, value);
+    for (; p + 1 < cols; ++p) {
+        if (isRunStart(row, p)) minValue = min(minValue, row[p]);
+    }
+    if (minValue == INT32_MAX) return IncreasingRun();
+
+    if (row[1] > row[0] && row[0] == minValue) return completeRun(row, cols, rowIndex, 0);
+    __m512i target = _mm512_set1_epi32(minValue);
+    for (p = 1; p + 17 <= cols; p += 16) {
+        __m512i previous = _mm512_loadu_si512(row + p - 1);
+        __m512i current = _mm512_loadu_si512(row + p);
+        __m512i next = _mm512_loadu_si512(row + p + 1);
+        __mmask16 hits = _mm512_cmpeq_epi32_mask(current, target) &
+                         _mm512_cmple_epi32_mask(current, previous) &
+                         _mm512_cmpgt_epi32_mask(next, current);
+        if (hits) return completeRun(row, cols, rowIndex, p + __builtin_ctz(hits));
+    }
+    for (; p + 1 < cols; ++p) {
+        if (row[p] == minValue && isRunStart(row, p)) return completeRun(row, cols, rowIndex, p);
+    }
+    return IncreasingRun();
+}
+#endif
+
+// вариант поиска серий в строке
+typedef IncreasingRun (*RunKernel)(const int*, int, int);
+
+// самый быстрый вариант, который поддерживает процессор (выбирается один раз)
+RunKernel selectRunKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx512f")) return findBestRunInRowAvx512;
+    if (__builtin_cpu_supports("avx2")) return findBestRunInRowAvx2;
+#endif
+    return findBestRunInRowScalar;
+}
+
+// поиск лучшей серии в строке лучшим доступным вариантом
+IncreasingRun findBestRunInRow(const int* row, int cols, int rowIndex) {
+    static const RunKernel kernel = selectRunKernel();
+    return kernel(row, cols, rowIndex);
+}
+
+// функция для поиска возрастающей последовательности с минимальным начальным элементом в строках матрицы;
+// строки делятся между потоками, лучшие серии потоков сводятся в конце
+vector<int> findIncreasingSequence(const IntMatrix& matrix, int threadCount = 0) {
+    LR6_PROFILE_ZONE("findIncreasingSequence");
+    // на маленьких матрицах потоки только мешают
+    if (size_t(matrix.rows) * matrix.cols < (size_t(1) << 16)) threadCount = 1;
+    threadCount = resolveThreadCount(threadCount, matrix.rows);
+
+    vector<IncreasingRun> best(threadCount); // лучшая серия каждого потока
+    auto scanRows = [&](int index) {
+        LR6_PROFILE_ZONE("findIncreasingSequence: просмотр строк");
+        int firstRow = int(int64_t(matrix.rows) * index / threadCount);
+        int lastRow = int(int64_t(matrix.rows) * (index + 1) / threadCount);
+        for (int r = firstRow; r < lastRow; ++r) { // перебираем строки своего диапазона
+            IncreasingRun run = findBestRunInRow(matrix.row(r), matrix.cols, r);
+            if (isBetterRun(run, best[index])) best[index] = run;
+        }
+    };
+    runOnThreads(threadCount, scanRows);
+
+    // сведение результатов потоков
+    IncreasingRun result;
+    for (const auto& run : best) {
+        if (isBetterRun(run, result)) result = run;
+    }
+    if (result.row < 0) return {}; // возрастающих последовательностей нет
+    const int* row = matrix.row(result.row);
+    return vector<int>(row + result.start, row + result.start + result.length); // копируем только ответ
+}
+
+// отсортированные пары (элемент, количество вхождений)
+typedef vector<pair<int, int64_t>> ElementCounts;
+
+// хеш-таблица с открытой адресацией для подсчета элементов широкого диапазона
+class CountingHashTable {
+public:
+    explicit CountingHashTable(size_t expected = 1024) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        keys.assign(capacity, 0);
+        counts.assign(capacity, 0);
+        mask = capacity - 1;
+    }
+
+    // добавление count вхождений key (нулевой счетчик означает пустую ячейку)
+    void add(int key, int64_t count = 1) {
+        size_t slot = hash(key);
+        while (counts[slot] != 0 && keys[slot] != key) slot = (slot + 1) & mask;
+        if (counts[slot] == 0) {
+            keys[slot] = key;
+            if (++used * 2 > keys.size()) {
+                counts[slot] = count;
+                grow();
+                return;
+            }
+        }
+        counts[slot] += count;
+    }
+
+    // перенос всех элементов в другую таблицу
+    void mergeInto(CountingHashTable& other) const {
+        for (size_t slot = 0; slot < keys.size(); ++slot) {
+            if (counts[slot]) other.add(keys[slot], counts[slot]);
+        }
+    }
+
+    // все пары, отсортированные по элементу
+    ElementCounts sorted() const {
+        ElementCounts result;
+        result.reserve(used);
+        for (size_t slot = 0; slot < keys.size(); ++slot) {
+            if (counts[slot]) result.emplace_back(keys[slot], counts[slot]);
+        }
+        sort(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    // мультипликативный хеш фибоначчи
+    size_t hash(int key) const {
+        return size_t((uint64_t(uint32_t(key)) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    }
+
+    // увеличение таблицы вдвое с перераспределением элементов
+    void grow() {
+        vector<int> oldKeys;
+        vector<int64_t> oldCounts;
+        oldKeys.swap(keys);
+        oldCounts.swap(counts);
+        keys.assign(oldKeys.size() * 2, 0);
+        counts.assign(oldKeys.size() * 2, 0);
+        mask = keys.size() - 1;
+        used = 0;
+        for (size_t slot = 0; slot < oldKeys.size(); ++slot) {
+            if (oldCounts[slot]) add(oldKeys[slot], oldCounts[slot]);
+        }
+    }
+
+    vector<int> keys;       // элементы
+    vector<int64_t> counts; // количество вхождений (0 - ячейка пуста)
+    size_t mask = 0;        // размер таблицы - 1
+    size_t used = 0;        // занятые ячейки
+};
+
+// наибольший диапазон значений, для которого выгоден плотный массив счетчиков
+const int64_t denseHistogramLimit = int64_t(1) << 22;
+
+// функция для подсчета количества вхождений каждого уникального элемента в матрице;
+// по наблюдаемому диапазону значений выбирается плотный массив счетчиков или хеш-таблица,
+// каждый поток считает свои строки отдельно, локальные результаты сливаются в конце
+ElementCounts countUniqueElements(const IntMatrix& matrix, int threadCount = 0) {
+    LR6_PROFILE_ZONE("countUniqueElements");
+    int64_t elements = int64_t(matrix.rows) * matrix.cols;
+    if (elements == 0) return {};
+    // на маленьких матрицах потоки только мешают
+    if (elements < (int64_t(1) << 16)) threadCount = 1;
+    threadCount = resolveThreadCount(threadCount, matrix.rows);
+    auto rowRange = [&](int index, int& firstRow, int& lastRow) {
+        firstRow = int(int64_t(matrix.rows) * index / threadCount);
+        lastRow = int(int64_t(matrix.rows) * (index + 1) / threadCount);
+    };
+
+    // первый проход: диапазон значений
+    vector<int> minValues(threadCount, INT32_MAX);
+    vector<int> maxValues(threadCount, INT32_MIN);
+    runOnThreads(threadCount, [&](int index) {
+        int firstRow, lastRow;
+        rowRange(index, firstRow, lastRow);
+        int low = INT32_MAX, high = INT32_MIN;
+        for (int r = firstRow; r < lastRow; ++r) {
+            const int* row = matrix.row(r);
+            for (int j = 0; j < matrix.cols; ++j) {
+                low = min(low, row[j]);
+                high = max(high, row[j]);
+            }
+        }
+        minValues[index] = low;
+        maxValues[index] = high;
+    });
+    int minValue = *min_element(minValues.begin(), minValues.end());
+    int maxValue = *max_element(maxValues.begin(), maxValues.end());
+    int64_t range = int64_t(maxValue) - minValue + 1;
+
+    ElementCounts counts;
+    // узкий диапазон (например, -50..50): массив счетчиков на поток
+    if (range <= denseHistogramLimit && range <= max<int64_t>(elements, 1024)) {
+        vector<vector<int64_t>> histograms(threadCount);
+        runOnThreads(threadCount, [&](int index) {
+            int firstRow, lastRow;
+            rowRange(index, firstRow, lastRow);
+            vector<int64_t> histogram(range, 0);
+            for (int r = firstRow; r < lastRow; ++r) {
+                const int* row = matrix.row(r);
+                for (int j = 0; j < matrix.cols; ++j) histogram[int64_t(row[j]) - minValue]++;
+            }
+            histograms[index].swap(histogram);
+        });
+        // слияние: массив уже упорядочен по значению
+        for (int64_t value = 0; value < range; ++value) {
+            int64_t total = 0;
+            for (const auto& histogram : histograms) total += histogram[value];
+            if (total) counts.emplace_back(int(minValue + value), total);
+        }
+        return counts;
+    }
+
+    // широкий диапазон: хеш-таблица с открытой адресацией на поток
+    vector<CountingHashTable> tables(threadCount);
+    runOnThreads(threadCount, [&](int index) {
+        int firstRow, lastRow;
+        rowRange(index, firstRow, lastRow);
+        // различных значений не больше, чем элементов в строках потока и значений в диапазоне
+        CountingHashTable table(size_t(min<int64_t>(range, int64_t(lastRow - firstRow) * matrix.cols)));
+        for (int r = firstRow; r < lastRow; ++r) {
+            const int* row = matrix.row(r);
+            for (int j = 0; j < matrix.cols; ++j) table.add(row[j]);
+        }
+        tables[index] = move(table);
+    });
+    for (int index = 1; index < threadCount; ++index) tables[index].mergeInto(tables[0]);
+    return tables[0].sorted(); // результат упорядочен для вывода
+}
+
+// последовательное чтение матрицы из файла частями по несколько строк;
+// двоичный формат узнается по сигнатуре, иначе файл читается как текст (строка файла - строка матрицы)
+class MatrixStreamReader {
+public:
+    ~MatrixStreamReader() {
+        if (file) fclose(file);
+    }
+
+    // открытие файла и определение формата и числа столбцов
+    bool open(const string& filename) {
+        file = fopen(filename.c_str(), "rb");
+        if (!file) {
+            cerr << "ошибка при открытии файла " << filename << endl;
+            return false;
+        }
+        char magic[sizeof(binaryMatrixMagic)];
+        size_t got = fread(magic, 1, sizeof(magic), file);
+        if (got == sizeof(magic) && memcmp(magic, binaryMatrixMagic, sizeof(magic)) == 0) {
+            binary = true;
+            uint64_t header[2];
+            if (fread(header, sizeof(uint64_t), 2, file) != 2 || header[1] == 0 || header[1] > INT32_MAX) {
+                cerr << "файл " << filename << " поврежден: неверный заголовок" << endl;
+                return false;
+            }
+            rowsLeft = header[0];
+            cols = int(header[1]);
+            return true;
+        }
+        // текстовый файл: уже прочитанные байты остаются в буфере разбора
+        buffer.assign(magic, magic + got);
+        vector<int> firstRow;
+        if (!readTextRow(firstRow) || firstRow.empty()) {
+            cerr << "файл " << filename << " не содержит строк матрицы" << endl;
+            return false;
+        }
+        cols = int(firstRow.size());
+        pendingRow.swap(firstRow);
+        return true;
+    }
+
+    // число столбцов матрицы в файле
+    int columns() const { return cols; }
+
+    // чтение следующих строк в chunk (не больше chunk.rows); возвращает число прочитанных строк
+    int readChunk(IntMatrix& chunk) {
+        int count = 0;
+        if (binary) {
+            int wanted = int(min<uint64_t>(rowsLeft, uint64_t(chunk.rows)));
+            for (; count < wanted; ++count) {
+                if (fread(chunk.row(count), sizeof(int), cols, file) != size_t(cols)) {
+                    cerr << "файл матрицы оборвался" << endl;
+                    failed = true;
+                    break;
                 }
             }
-            if (currentSeq.size() > 1 && currentSeq[0] < minStart) { // если последовательность длиной > 1 и её старт меньше текущего минимального
-                minStart = currentSeq[0]; // обновляем минимальный старт
-                result = currentSeq; // сохраняем текущую последовательность как лучшую
+            rowsLeft -= count;
+            return count;
+        }
+        vector<int> values;
+        while (count < chunk.rows) {
+            if (!pendingRow.empty()) {
+                values.swap(pendingRow);
+                pendingRow.clear();
+            } else if (!readTextRow(values)) {
+                break;
+            }
+            if (values.empty()) continue; // пустые строки пропускаем
+            if (int(values.size()) != cols) {
+                cerr << "в строке матрицы " << values.size() << " чисел вместо " << cols << endl;
+                failed = true;
+                break;
+            }
+            memcpy(chunk.row(count++), values.data(), cols * sizeof(int));
+        }
+        return count;
+    }
+
+    // чтение прервалось из-за ошибки в файле
+    bool hasFailed() const { return failed; }
+
+private:
+    // разбор одной текстовой строки; false - конец файла
+    bool readTextRow(vector<int>& values) {
+        values.clear();
+        while (true) {
+            // ищем конец строки в уже прочитанных данных
+            size_t newline = buffer.find('\n', position);
+            if (newline == string::npos && !endOfFile) {
+                // дочитываем следующий блок файла, сохранив незаконченную строку
+                buffer.erase(0, position);
+                position = 0;
+                size_t oldSize = buffer.size();
+                buffer.resize(oldSize + (1 << 20));
+                size_t got = fread(&buffer[oldSize], 1, 1 << 20, file);
+                buffer.resize(oldSize + got);
+                if (got == 0) endOfFile = true;
+                continue;
+            }
+            size_t end = newline == string::npos ? buffer.size() : newline;
+            if (position >= end && newline == string::npos) return false; // данных больше нет
+            // разбор чисел строки через from_chars
+            const char* current = buffer.data() + position;
+            const char* last = buffer.data() + end;
+            while (current < last) {
+                while (current < last && (*current == ' ' || *current == '\t' || *current == '\r')) ++current;
+                if (current == last) break;
+                int value;
+                auto [next, error] = from_chars(current, last, value);
+                if (error != errc()) {
+                    cerr << "в файле матрицы встретилось не число" << endl;
+                    failed = true;
+                    return false;
+                }
+                values.push_back(value);
+                current = next;
             }
+            position = newline == string::npos ? buffer.size() : newline + 1;
+            return true;
         }
     }
 
-    return result; // возвращаем найденную последовательность
+    FILE* file = nullptr;     // открытый файл
+    bool binary = false;      // двоичный формат
+    bool failed = false;      // ошибка чтения или разбора
+    int cols = 0;             // число столбцов
+    uint64_t rowsLeft = 0;    // непрочитанные строки двоичного файла
+    string buffer;            // буфер текстового файла
+    size_t position = 0;      // позиция разбора в буфере
+    bool endOfFile = false;   // файл прочитан до конца
+    vector<int> pendingRow;   // первая строка текстового файла, прочитанная при открытии
+};
+
+// запись случайной матрицы в файл частями, без хранения всей матрицы в памяти;
+// содержимое совпадает с createMatrix с тем же seed
+bool saveRandomMatrix(const string& filename, int64_t rows, int cols, int minVal, int maxVal,
+                      uint64_t seed, bool text) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) {
+        cerr << "ошибка при создании файла " << filename << endl;
+        return false;
+    }
+    bool ok = true;
+    if (!text) {
+        uint64_t header[2] = {uint64_t(rows), uint64_t(cols)};
+        ok = fwrite(binaryMatrixMagic, sizeof(binaryMatrixMagic), 1, file) == 1 &&
+             fwrite(header, sizeof(uint64_t), 2, file) == 2;
+    }
+    MatrixArena arena;
+    int chunkRows = int(max<int64_t>(1, min<int64_t>(rows, (int64_t(1) << 22) / cols)));
+    IntMatrix chunk = allocateMatrix(arena, chunkRows, cols);
+    string line;
+    for (int64_t first = 0; ok && first < rows; first += chunkRows) {
+        chunk.rows = int(min<int64_t>(chunkRows, rows - first));
+        fillRandomRows(chunk, first, minVal, maxVal, seed);
+        for (int i = 0; ok && i < chunk.rows; ++i) {
+            if (!text) {
+                ok = fwrite(chunk.row(i), sizeof(int), cols, file) == size_t(cols);
+                continue;
+            }
+            line.clear();
+            char number[16];
+            for (int j = 0; j < cols; ++j) {
+                auto result = to_chars(number, number + sizeof(number), chunk(i, j));
+                line.append(number, result.ptr);
+                line += j + 1 < cols ? ' ' : '\n';
+            }
+            ok = fwrite(line.data(), 1, line.size(), file) == line.size();
+        }
+    }
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) cerr << "ошибка при записи файла " << filename << endl;
+    return ok;
 }
 
-// функция для подсчета количества вхождений каждого уникального элемента в матрице
-map<int, int> countUniqueElements(const vector<vector<int>>& matrix) {
-    map<int, int> counts; // создаем отображение для подсчета элементов
-    for (const auto& row : matrix) { // перебираем строки
-        for (int val : row) { // перебираем элементы строки
-            counts[val]++; // увеличиваем счетчик для текущего элемента
+// потоковый анализ матрицы из файла: задачи 1 и 2 за один последовательный проход,
+// в памяти одновременно только одна часть строк
+// время включает чтение и разбор: части читаются вперемешку с анализом
+int runStreamAnalysis(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "использование: " << argv[0] << " --stream <файл> [строк в части]" << endl;
+        return 1;
+    }
+    MatrixStreamReader reader;
+    if (!reader.open(argv[2])) return 1;
+    int cols = reader.columns();
+    // по умолчанию часть занимает около 16 мб
+    int chunkRows = argc > 3 ? atoi(argv[3]) : max(1, (1 << 22) / cols);
+    if (chunkRows <= 0) {
+        cerr << "размер части должен быть положительным" << endl;
+        return 1;
+    }
+
+    MatrixArena arena;
+    IntMatrix chunk = allocateMatrix(arena, chunkRows, cols);
+    IncreasingRun best;            // лучшая серия с глобальным номером строки
+    vector<int> bestSequence;      // ее элементы (строка к этому времени уже не в памяти)
+    CountingHashTable totalCounts; // накопленные количества вхождений
+    int64_t rowsRead = 0;
+
+    auto start = chrono::steady_clock::now();
+    while (true) {
+        chunk.rows = chunkRows;
+        int count = reader.readChunk(chunk);
+        if (count == 0) break;
+        chunk.rows = count;
+        // задача 1: лучшая серия части, номера строк глобальные
+        for (int r = 0; r < count; ++r) {
+            IncreasingRun run = findBestRunInRow(chunk.row(r), cols, 0);
+            run.row = run.row < 0 ? -1 : int(min<int64_t>(rowsRead + r, INT32_MAX));
+            if (isBetterRun(run, best)) {
+                best = run;
+                bestSequence.assign(chunk.row(r) + run.start, chunk.row(r) + run.start + run.length);
+            }
         }
+        // задача 2: подсчет по части и добавление к общему
+        for (const auto& entry : countUniqueElements(chunk)) totalCounts.add(entry.first, entry.second);
+        rowsRead += count;
     }
-    return counts; // возвращаем отображение с подсчетами
+    if (reader.hasFailed()) return 1;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "прочитано строк: " << rowsRead << ", столбцов: " << cols << " за " << seconds << " с" << endl;
+    cout << "найденная последовательность";
+    if (best.row >= 0) cout << " (строка " << best.row << ", позиция " << best.start << ")";
+    cout << ":" << endl;
+    for (int num : bestSequence) cout << num << " ";
+    cout << endl << "количество вхождений каждого элемента:" << endl;
+    for (const auto& pair : totalCounts.sorted()) cout << pair.first << ": " << pair.second << "\n";
+    cout << flush;
+    return 0;
+}
+
+// запись случайной матрицы в файл для потокового режима
+int runSaveMatrix(int argc, char* argv[]) {
+    if (argc < 7) {
+        cerr << "использование: " << argv[0]
+             << " --save-matrix <файл> <строки> <столбцы> <мин> <макс> [seed] [text]" << endl;
+        return 1;
+    }
+    int64_t rows = strtoll(argv[3], nullptr, 10);
+    int cols = atoi(argv[4]);
+    int minVal = atoi(argv[5]);
+    int maxVal = atoi(argv[6]);
+    uint64_t seed = argc > 7 ? strtoull(argv[7], nullptr, 10) : 1;
+    bool text = argc > 8 && string(argv[8]) == "text";
+    if (rows <= 0 || cols <= 0 || minVal > maxVal) {
+        cerr << "неверные размеры или диапазон матрицы" << endl;
+        return 1;
+    }
+    return saveRandomMatrix(argv[2], rows, cols, minVal, maxVal, seed, text) ? 0 : 1;
 }
 
 // функция для проверки, атакует ли конь короля
 bool isKnightAttacking(int nx, int ny, int kx, int ky) {
-    int dx = abs(nx - kx); // разница по x
-    int dy = abs(ny - ky); // разница по y
-    return (dx == 1 && dy == 2) || (dx == 2 && dy == 1); // конь атакует, если ходит по "букве Г"
+    // конь атакует, если ходит по "букве Г": клетка короля есть в таблице ходов коня
+    return attackTables().knight[squareIndex(nx, ny)] & squareBit(squareIndex(kx, ky));
 }
 
+// функция для проверки, атакует ли ферзь короля с учетом фигур на пути
 bool isQueenAttackCheck(int qx, int qy, int kx, int ky,
                      const vector<pair<int, int>>& queens,
                      const vector<pair<int, int>>& knights,
                      const pair<int, int>& kingpos) {
-    
-    // проверяем, находятся ли ферзь и король на одной линии
-    if (!(qx == kx || qy == ky || abs(qx - kx) == abs(qy - ky))) {
-        return false; // если нет прямой линии - атаки быть не может
-    }
-
-    // определяем направление движения от ферзя к королю
-    int dx = (kx == qx) ? 0 : (kx > qx) ? 1 : -1; // шаг по x
-    int dy = (ky == qy) ? 0 : (ky > qy) ? 1 : -1;  // шаг по y
-
-    // начинаем проверку клеток между ферзем и королем
-    int x = qx + dx;
-    int y = qy + dy;
-    while (x != kx || y != ky) {
-        // проверяем, не стоит ли на пути другой ферзь (кроме текущего)
-        for (const auto& q : queens) {
-            if (q != make_pair(qx, qy) && q == make_pair(x, y)) {
-                return false; // если нашли другого ферзя - путь перекрыт
+    // препятствиями служат все фигуры позиции, включая короля kingpos
+    Bitboard occupied = makeBitboardPosition(kingpos, queens, knights).occupied();
+    return queenAttacksSquare(squareIndex(qx, qy), squareIndex(kx, ky), occupied);
+}
+
+// функция для генерации случайных координат на шахматной доске size x size
+pair<int, int> generateRandomPosition(int size = 8) {
+    return {rand() % size, rand() % size}; // возвращает пару случайных чисел от 0 до size - 1
+}
+
+// функция проверки уникальности позиций
+bool ispositionunique(const vector<pair<int, int>>& positions, const pair<int, int>& newpos) {
+    // проверяем, что новая позиция не совпадает с существующими
+    return find(positions.begin(), positions.end(), newpos) == positions.end();
+}
+
+// статистика атак по множеству случайных позиций (король, 3 ферзя, 2 коня)
+struct AttackStatistics {
+    int64_t positions = 0;          // всего позиций
+    int64_t queenAttackers[4] = {}; // позиций с 0..3 атакующими ферзями
+    int64_t knightAttackers[3] = {}; // позиций с 0..2 атакующими конями
+    int64_t checks = 0;             // позиций, где короля атакует хотя бы одна фигура
+    int64_t multipleChecks = 0;     // позиций, где короля атакуют две фигуры и больше
+
+    // добавление статистики другого потока
+    void merge(const AttackStatistics& other) {
+        positions += other.positions;
+        for (int i = 0; i < 4; ++i) queenAttackers[i] += other.queenAttackers[i];
+        for (int i = 0; i < 3; ++i) knightAttackers[i] += other.knightAttackers[i];
+        checks += other.checks;
+        multipleChecks += other.multipleChecks;
+    }
+};
+
+// случайная позиция с различными клетками всех фигур; клетки берутся по 6 бит
+// из 64-битного числа генератора, занятость проверяется по битовой маске
+BitboardPosition randomUniquePosition(Xoshiro256& rng) {
+    uint64_t bits = 0;
+    int bitsLeft = 0;
+    Bitboard occupied = 0;
+    // следующая свободная клетка (повтор при попадании в занятую)
+    auto nextFreeSquare = [&] {
+        for (;;) {
+            if (bitsLeft < 6) {
+                bits = rng.next();
+                bitsLeft = 64;
             }
-        }
-        
-        // проверяем, не стоит ли на пути конь
-        for (const auto& k : knights) {
-            if (k == make_pair(x, y)) {
-                return false; // если нашли коня - путь перекрыт
+            int square = int(bits & 63);
+            bits >>= 6;
+            bitsLeft -= 6;
+            if (!(occupied & squareBit(square))) {
+                occupied |= squareBit(square);
+                return square;
             }
         }
-        
-        // проверяем, не стоит ли на пути сам король (кроме конечной позиции)
-        if (make_pair(x, y) == kingpos && (x != kx || y != ky)) {
-            return false; // если нашли короля на пути - путь перекрыт
+    };
+
+    BitboardPosition position;
+    position.kingSquare = nextFreeSquare();
+    for (int i = 0; i < 3; ++i) position.queens |= squareBit(nextFreeSquare());
+    for (int i = 0; i < 2; ++i) position.knights |= squareBit(nextFreeSquare());
+    return position;
+}
+
+// оценка count случайных позиций в threadCount потоках; позиции разбиты на блоки,
+// каждый блок генерируется собственным потоком генератора (seed, номер блока),
+// поэтому статистика не зависит от числа потоков
+AttackStatistics evaluateRandomPositions(int64_t count, uint64_t seed, int threadCount = 0) {
+    const int64_t blockSize = 1 << 16;
+    int64_t blocks = (count + blockSize - 1) / blockSize;
+    threadCount = resolveThreadCount(threadCount, blocks);
+    vector<AttackStatistics> partial(threadCount);
+
+    runOnThreads(threadCount, [&](int index) {
+        AttackStatistics stats;
+        for (int64_t block = index; block < blocks; block += threadCount) {
+            Xoshiro256 rng(seed, uint64_t(block));
+            int64_t end = min(count, (block + 1) * blockSize);
+            for (int64_t i = block * blockSize; i < end; ++i) {
+                BitboardPosition position = randomUniquePosition(rng);
+                int queens = __builtin_popcountll(queensAttackingKing(position));
+                int knights = __builtin_popcountll(knightsAttackingKing(position));
+                stats.queenAttackers[queens]++;
+                stats.knightAttackers[knights]++;
+                stats.checks += queens + knights > 0;
+                stats.multipleChecks += queens + knights > 1;
+            }
+            stats.positions += end - block * blockSize;
         }
+        partial[index] = stats;
+    });
 
-        // переходим к следующей клетке по направлению к королю
-        x += dx;
-        y += dy;
+    AttackStatistics total;
+    for (const auto& stats : partial) total.merge(stats);
+    return total;
+}
+
+// метод монте-карло: вероятности атак на короля по множеству случайных позиций
+int runMonteCarlo(int argc, char* argv[]) {
+    int64_t count = argc > 2 ? strtoll(argv[2], nullptr, 10) : 10000000;
+    int threadCount = argc > 3 ? atoi(argv[3]) : 0;
+    uint64_t seed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 1;
+    if (count <= 0) {
+        cerr << "использование: " << argv[0] << " --monte-carlo [позиций] [потоки] [seed]" << endl;
+        return 1;
     }
 
-    return true; // если дошли до короля без препятствий - атака возможна
+    auto start = chrono::steady_clock::now();
+    AttackStatistics stats = evaluateRandomPositions(count, seed, threadCount);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // одна сводная таблица: событие, число позиций, доля
+    auto share = [&](int64_t value) { return double(value) / double(stats.positions); };
+    cout << "позиций: " << stats.positions << ", время " << seconds << " с ("
+         << double(stats.positions) / max(seconds, 1e-9) / 1e6 << " млн/с)" << endl;
+    cout << "событие\tпозиций\tдоля" << endl;
+    for (int i = 0; i < 4; ++i)
+        cout << "ферзей атакует: " << i << "\t" << stats.queenAttackers[i] << "\t" << share(stats.queenAttackers[i]) << endl;
+    for (int i = 0; i < 3; ++i)
+        cout << "коней атакует: " << i << "\t" << stats.knightAttackers[i] << "\t" << share(stats.knightAttackers[i]) << endl;
+    cout << "король под атакой\t" << stats.checks << "\t" << share(stats.checks) << endl;
+    cout << "атака двумя и более\t" << stats.multipleChecks << "\t" << share(stats.multipleChecks) << endl;
+    return 0;
 }
-// функция для генерации случайных координат на шахматной доске
-pair<int, int> generateRandomPosition() {
-    return {rand() % 8, rand() % 8}; // возвращает пару случайных чисел от 0 до 7
+
+// позиция на доске произвольного размера с заданным числом ферзей и коней
+int runBoard(int argc, char* argv[]) {
+    if (argc < 5) {
+        cerr << "использование: " << argv[0] << " --board <размер> <ферзей> <коней> [seed]" << endl;
+        return 1;
+    }
+    int size = atoi(argv[2]);
+    int queenCount = atoi(argv[3]);
+    int knightCount = atoi(argv[4]);
+    uint64_t seed = argc > 5 ? strtoull(argv[5], nullptr, 10) : 1;
+    if (size <= 0 || size > 4096 || queenCount < 0 || knightCount < 0 ||
+        int64_t(queenCount) + knightCount + 1 > int64_t(size) * size) {
+        cerr << "фигуры должны помещаться на доску, размер доски от 1 до 4096" << endl;
+        return 1;
+    }
+
+    Xoshiro256 rng(seed, 0);
+    BoardPosition position = randomBoardPosition(size, queenCount, knightCount, rng);
+    boardTables(size); // таблицы строятся заранее, чтобы не попасть в замер
+    auto start = chrono::steady_clock::now();
+    vector<int> queenAttackers = findQueenAttackers(position);
+    vector<int> knightAttackers = findKnightAttackers(position);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "доска " << size << "x" << size << ", ферзей " << queenCount << ", коней " << knightCount << endl;
+    cout << "позиция короля: " << squareName(size, position.kingSquare) << endl;
+    cout << "ферзи, атакующие короля:" << endl;
+    for (int square : queenAttackers) cout << squareName(size, square) << " ";
+    cout << endl;
+    cout << "кони, атакующие короля:" << endl;
+    for (int square : knightAttackers) cout << squareName(size, square) << " ";
+    cout << endl;
+    cout << "поиск атак: " << seconds * 1e6 << " мкс" << endl;
+    // доску выводим, пока столбцы обозначаются одной буквой
+    if (size <= 26) {
+        cout << "Шахматная доска:" << endl;
+        printBoard(position);
+    }
+    return 0;
 }
 
-// функция проверки уникальности позиций
-bool ispositionunique(const vector<pair<int, int>>& positions, const pair<int, int>& newpos) {
-    // проверяем, что новая позиция не совпадает с существующими
-    return find(positions.begin(), positions.end(), newpos) == positions.end();
+// вывод случайной матрицы в стандартный поток: текстом или двоичным дампом
+int runPrintMatrix(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "использование: " << argv[0] << " --print <строки> <столбцы> [text|binary] [seed]" << endl;
+        return 1;
+    }
+    int rows = atoi(argv[2]);
+    int cols = atoi(argv[3]);
+    bool binary = argc > 4 && string(argv[4]) == "binary";
+    uint64_t seed = argc > 5 ? strtoull(argv[5], nullptr, 10) : 1;
+    if (rows <= 0 || cols <= 0) {
+        cerr << "размеры матрицы должны быть положительными" << endl;
+        return 1;
+    }
+    MatrixArena arena;
+    IntMatrix matrix = createMatrix(arena, rows, cols, 0, 100, seed);
+    auto start = chrono::steady_clock::now();
+    printMatrix(matrix, binary);
+    cout.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    // время выводим в поток ошибок, чтобы не портить данные
+    cerr << "вывод " << double(rows) * cols << " элементов за " << seconds << " с" << endl;
+    return cout ? 0 : 1;
+}
+
+// замер генерации большой матрицы: время и контрольная сумма (одинаковая при любом числе потоков)
+int runGenerate(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "использование: " << argv[0] << " --generate <строки> <столбцы> [потоки] [seed]" << endl;
+        return 1;
+    }
+    int rows = atoi(argv[2]);
+    int cols = atoi(argv[3]);
+    int threadCount = argc > 4 ? atoi(argv[4]) : 0;
+    uint64_t seed = argc > 5 ? strtoull(argv[5], nullptr, 10) : 1;
+    if (rows <= 0 || cols <= 0) {
+        cerr << "размеры матрицы должны быть положительными" << endl;
+        return 1;
+    }
+
+    MatrixArena arena;
+    auto start = chrono::steady_clock::now();
+    IntMatrix matrix = createMatrix(arena, rows, cols, 0, 100, seed, threadCount);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // контрольная сумма для проверки воспроизводимости
+    uint64_t checksum = 0;
+    for (int i = 0; i < rows; ++i) {
+        const int* row = matrix.row(i);
+        for (int j = 0; j < cols; ++j) checksum = checksum * 31 + uint64_t(row[j]);
+    }
+    double elements = double(rows) * cols;
+    cout << "сгенерировано " << elements << " элементов за " << seconds << " с ("
+         << elements / max(seconds, 1e-9) / 1e6 << " млн/с), контрольная сумма " << checksum << endl;
+    return 0;
 }
 
-int main() {
+// сравнение вариантов поиска серий на типичных формах матриц
+int runRunsBenchmark(int argc, char* argv[]) {
+    // формы матриц: из задания, широкие строки, узкие строки; либо заданная аргументами
+    vector<pair<int, int>> shapes = {{5, 5}, {1000, 100000}, {100000, 100}, {10000, 1000}};
+    if (argc > 3) shapes = {{atoi(argv[2]), atoi(argv[3])}};
+
+    vector<pair<string, RunKernel>> kernels = {{"scalar", findBestRunInRowScalar}};
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", findBestRunInRowAvx2});
+    if (__builtin_cpu_supports("avx512f")) kernels.push_back({"avx512", findBestRunInRowAvx512});
+#endif
+
+    cout << "строки x столбцы\tдиапазон\tвариант\tмс за проход\tГБ/с" << endl;
+    for (auto [rows, cols] : shapes) {
+        if (rows <= 0 || cols <= 0) {
+            cerr << "размеры матрицы должны быть положительными" << endl;
+            return 1;
+        }
+        // узкий диапазон из задания дает короткие серии, широкий - длинные
+        for (int maxVal : {100, 1000000000}) {
+            MatrixArena arena;
+            IntMatrix matrix = createMatrix(arena, rows, cols, 0, maxVal, 2024);
+            IncreasingRun reference;
+            for (size_t k = 0; k < kernels.size(); ++k) {
+                // повторяем проход, пока не наберется хотя бы 0.2 с
+                IncreasingRun result;
+                int passes = 0;
+                auto start = chrono::steady_clock::now();
+                double seconds = 0;
+                do {
+                    result = IncreasingRun();
+                    for (int r = 0; r < rows; ++r) {
+                        IncreasingRun run = kernels[k].second(matrix.row(r), cols, r);
+                        if (isBetterRun(run, result)) result = run;
+                    }
+                    passes++;
+                    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                } while (seconds < 0.2);
+
+                // все варианты обязаны находить одну и ту же серию
+                if (k == 0) reference = result;
+                bool same = result.row == reference.row && result.start == reference.start &&
+                            result.length == reference.length;
+                double perPass = seconds / passes;
+                cout << rows << " x " << cols << "\t0.." << maxVal << "\t" << kernels[k].first << "\t"
+                     << perPass * 1e3 << "\t" << double(rows) * cols * sizeof(int) / perPass * 1e-9
+                     << (same ? "" : "\tРЕЗУЛЬТАТ ОТЛИЧАЕТСЯ!") << endl;
+                if (!same) return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// без main, когда файл подключается в общий стенд замеров lr6-bench.cpp
+#ifndef LR6_NO_MAIN
+int main(int argc, char* argv[]) {
+    // отдельные режимы замеров
+    if (argc > 1 && string(argv[1]) == "--generate") {
+        return runGenerate(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-runs") {
+        return runRunsBenchmark(argc, argv);
+    }
+    // статистика атак по случайным шахматным позициям
+    if (argc > 1 && string(argv[1]) == "--monte-carlo") {
+        return runMonteCarlo(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--board") {
+        return runBoard(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--print") {
+        return runPrintMatrix(argc, argv);
+    }
+    // потоковая обработка матрицы из файла
+    if (argc > 1 && string(argv[1]) == "--stream") {
+        return runStreamAnalysis(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--save-matrix") {
+        return runSaveMatrix(argc, argv);
+    }
+
     srand(time(0)); // инициализация генератора случайных чисел текущим временем
+    // seed для матриц можно задать аргументом --seed, чтобы повторить запуск
+    uint64_t seed = time(0);
+    if (argc > 2 && string(argv[1]) == "--seed") seed = strtoull(argv[2], nullptr, 10);
+    cout << "seed матриц: " << seed << endl;
+    MatrixArena arena; // общая память для матриц всех задач
 
 
     // задача 1: поиск возрастающей последовательности с минимальным начальным элементом
     cout << "задача 1:" << endl;
     int m = 5, n = 5; // размеры матрицы
-    auto mat = createMatrix(m, n, 0, 100); // создаем матрицу 5x5 с числами от 0 до 100
+    auto mat = createMatrix(arena, m, n, 0, 100, seed); // создаем матрицу 5x5 с числами от 0 до 100
     cout << "матрица:" << endl; // выводим заголовок
     printMatrix(mat); // выводим матрицу
     auto seq = findIncreasingSequence(mat); // ищем возрастающую последовательность
@@ -207,7 +1432,7 @@ int main() {
 
     // задача 2: подсчет уникальных элементов в матрице
     cout << "задача 2:" << endl; // выводим заголовок
-    auto mat2 = createMatrix(m, n, -50, 50); // создаем матрицу 5x5 с числами от -50 до 50
+    auto mat2 = createMatrix(arena, m, n, -50, 50, seed + 1); // создаем матрицу 5x5 с числами от -50 до 50
     cout << "матрица:" << endl; // выводим заголовок
     printMatrix(mat2); // выводим матрицу
     auto counts = countUniqueElements(mat2); // считаем вхождения каждого элемента
@@ -336,3 +1561,4 @@ cout << endl; // перевод строки
 
     return 0; 
 }
+#endif
@@ -216,11 +216,18 @@ impl fmt::Display for ChessBoard {
 
 // функция для поиска возрастающей последовательности с минимальным начальным элементом
 fn find_increasing_sequence(matrix: &[Vec<i32>]) -> Vec<i32> {
+    find_increasing_sequence_with_position(matrix).2
+}
+
+// то же, но вместе с номером строки и позицией начала последовательности (None, если ее нет)
+fn find_increasing_sequence_with_position(matrix: &[Vec<i32>]) -> (Option<usize>, usize, Vec<i32>) {
     let mut result = Vec::new();
     let mut min_start = i32::MAX; // начальное значение больше любого возможного элемента
+    let mut found_row = None;
+    let mut found_start = 0;
 
     // перебираем каждую строку матрицы
-    for row in matrix {
+    for (row_index, row) in matrix.iter().enumerate() {
         // перебираем каждый элемент строки как начальный элемент последовательности
         for i in 0..row.len() {
             let mut current_seq = vec![row[i]];
@@ -238,11 +245,13 @@ fn find_increasing_sequence(matrix: &[Vec<i32>]) -> Vec<i32> {
             if current_seq.len() > 1 && current_seq[0] < min_start {
                 min_start = current_seq[0];
                 result = current_seq;
+                found_row = Some(row_index);
+                found_start = i;
             }
         }
     }
 
-    result
+    (found_row, found_start, result)
 }
 
 // функция для подсчета уникальных элементов в матрице
@@ -260,7 +269,66 @@ fn count_unique_elements(matrix: &[Vec<i32>]) -> HashMap<i32, usize> {
     counts
 }
 
+// анализ матрицы из текстового файла (строка файла - строка матрицы) для сверки
+// с потоковым режимом реализации на c++ (lr6-1 --stream): задачи 1 и 2, тот же формат вывода
+fn run_analyze(filename: &str) -> i32 {
+    // замер включает чтение и разбор файла: потоковый режим lr6-1 на c++ читает файл частями
+    // вперемешку с анализом и отделить чтение не может, поэтому обе версии замеряют одно и то же
+    let start = std::time::Instant::now();
+    let text = match std::fs::read_to_string(filename) {
+        Ok(text) => text,
+        Err(error) => {
+            eprintln!("ошибка при открытии файла {}: {}", filename, error);
+            return 1;
+        }
+    };
+    let mut matrix: Vec<Vec<i32>> = Vec::new();
+    for (line_index, line) in text.lines().enumerate() {
+        if line.trim().is_empty() {
+            continue;
+        }
+        let row: Result<Vec<i32>, _> = line.split_whitespace().map(|token| token.parse::<i32>()).collect();
+        match row {
+            Ok(row) if matrix.is_empty() || row.len() == matrix[0].len() => matrix.push(row),
+            _ => {
+                eprintln!("ошибка в строке {} файла {}", line_index + 1, filename);
+                return 1;
+            }
+        }
+    }
+    let cols = matrix.first().map_or(0, |row| row.len());
+
+    let (row, position, sequence) = find_increasing_sequence_with_position(&matrix);
+    let counts = count_unique_elements(&matrix);
+    let seconds = start.elapsed().as_secs_f64();
+
+    // весь вывод собирается в строку: println! на каждый элемент слишком медленный
+    let mut output = format!("прочитано строк: {}, столбцов: {} за {} с\n", matrix.len(), cols, seconds);
+    output.push_str("найденная последовательность");
+    if let Some(row) = row {
+        output.push_str(&format!(" (строка {}, позиция {})", row, position));
+    }
+    output.push_str(":\n");
+    for num in &sequence {
+        output.push_str(&format!("{} ", num));
+    }
+    output.push_str("\nколичество вхождений каждого элемента:\n");
+    let mut sorted_counts: Vec<_> = counts.iter().collect();
+    sorted_counts.sort_by_key(|&(k, _)| k);
+    for (key, value) in sorted_counts {
+        output.push_str(&format!("{}: {}\n", key, value));
+    }
+    print!("{}", output);
+    0
+}
+
 fn main() {
+    // режим сверки: анализ матрицы из файла
+    let args: Vec<String> = std::env::args().collect();
+    if args.len() > 2 && args[1] == "--analyze" {
+        std::process::exit(run_analyze(&args[2]));
+    }
+
     // задача 1: поиск возрастающей последовательности
     println!("задача 1:");
     let mat = create_matrix(5, 5, 0, 100);
@@ -201,6 +201,36 @@ fn aes_encrypt_block_with_log(block: &[u8; 16], key: &AesKey) -> ([u8; 16], Stri
     (state.to_bytes(), log)
 }
 
+// шифрование блока без журнала (для массовой обработки)
+fn aes_encrypt_block(block: &[u8; 16], key: &AesKey) -> [u8; 16] {
+    let mut state = AesState::from_bytes(block);
+    state.add_round_key(key.round_key(0));
+    for round in 1..10 {
+        state.sub_bytes();
+        state.shift_rows();
+        state.mix_columns();
+        state.add_round_key(key.round_key(round));
+    }
+    state.sub_bytes();
+    state.shift_rows();
+    state.add_round_key(key.round_key(10));
+    state.to_bytes()
+}
+
+// режим OFB без журнала; шифрование и расшифрование совпадают
+fn aes_ofb_process(key: &[u8; 16], iv: &[u8; 16], input: &[u8]) -> Vec<u8> {
+    let (aes_key, _) = AesKey::expand_with_log(key);
+    let mut feedback = *iv;
+    let mut output = vec![0; input.len()];
+    for (i, chunk) in input.chunks(16).enumerate() {
+        feedback = aes_encrypt_block(&feedback, &aes_key);
+        for (j, &byte) in chunk.iter().enumerate() {
+            output[i*16 + j] = byte ^ feedback[j];
+        }
+    }
+    output
+}
+
 fn aes_ofb_process_with_log(key: &[u8; 16], iv: &[u8; 16], input: &[u8]) -> (Vec<u8>, String) {
     let (aes_key, key_log) = AesKey::expand_with_log(key);
     let mut feedback = iv.clone();
@@ -251,7 +281,47 @@ fn save_to_file(filename: &str, data: &[u8]) -> io::Result<()> {
     Ok(())
 }
 
+// разбор 16 байт из 32 шестнадцатеричных цифр
+fn parse_hex_block(text: &str) -> Option<[u8; 16]> {
+    if text.len() != 32 || !text.is_ascii() {
+        return None;
+    }
+    let mut bytes = [0; 16];
+    for i in 0..16 {
+        bytes[i] = u8::from_str_radix(&text[2*i..2*i + 2], 16).ok()?;
+    }
+    Some(bytes)
+}
+
+// обработка файла в режиме OFB без журнала (для сверки с реализацией на c++):
+// lr6-2r --ofb <ключ hex> <iv hex> <вход> <выход>
+fn run_ofb(args: &[String]) -> io::Result<()> {
+    if args.len() < 6 {
+        eprintln!("использование: {} --ofb <ключ hex> <iv hex> <входной файл> <выходной файл>", args[0]);
+        std::process::exit(1);
+    }
+    let (key, iv) = match (parse_hex_block(&args[2]), parse_hex_block(&args[3])) {
+        (Some(key), Some(iv)) => (key, iv),
+        _ => {
+            eprintln!("ключ и iv задаются 32 шестнадцатеричными цифрами");
+            std::process::exit(1);
+        }
+    };
+    let input = load_from_file(&args[4])?;
+    let start = std::time::Instant::now();
+    let output = aes_ofb_process(&key, &iv, &input);
+    let seconds = start.elapsed().as_secs_f64();
+    save_to_file(&args[5], &output)?;
+    println!("обработано {} байт за {} с", input.len(), seconds);
+    Ok(())
+}
+
 fn main() -> io::Result<()> {
+    let args: Vec<String> = std::env::args().collect();
+    if args.len() > 1 && args[1] == "--ofb" {
+        return run_ofb(&args);
+    }
+
     println!("==============================================");
     println!("|| программа для шифрования/дешифрования aes ||");
     println!("||          режим работы: ofb               ||");
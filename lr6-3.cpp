@@ -3,32 +3,53 @@
 #include <cmath>     
 #include <iomanip>   
 #include <algorithm> 
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <charconv>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lr6-output.h"
+#include "lr6-profile.h"
 
 using namespace std; 
 
 // функция для вывода матрицы на экран
 void printMatrix(const vector<vector<double>>& matrix) {
+    // числа копятся в буфере и выводятся большими частями
+    OutputBuffer out(cout);
     // перебираем каждую строку матрицы
     for (const auto& row : matrix) {
         // перебираем каждый элемент строки
         for (double value : row) {
-            // выводим элемент с шириной 10 символов
-            cout << setw(10) << value << " ";
+            // выводим элемент с шириной 10 символов в текущем формате cout
+            out.writeDouble(value, cout, 10);
+            out.put(' ');
         }
         // переходим на новую строку после вывода всех элементов строки
-        cout << endl;
+        out.put('\n');
     }
 }
 
 // функция для вывода вектора на экран
 void printVector(const vector<double>& vec) {
+    OutputBuffer out(cout);
     // перебираем все элементы вектора
     for (double value : vec) {
-        // выводим элемент с шириной 10 символов
-        cout << setw(10) << value << " ";
+        // выводим элемент с шириной 10 символов в текущем формате cout
+        out.writeDouble(value, cout, 10);
+        out.put(' ');
     }
     // переходим на новую строку после вывода всех элементов
-    cout << endl;
+    out.put('\n');
 }
 
 // функция проверки диагонального преобладания матрицы
@@ -104,39 +125,168 @@ bool tryMakeDiagonallyDominant(vector<vector<double>>& matrix, vector<double>& v
     return true;
 }
 
-// функция для вычисления невязки
-vector<double> calculateResidual(const vector<vector<double>>& matrix, 
-                               const vector<double>& vectorB, 
-                               const vector<double>& solution) {
-    // получаем размер системы
+// сумма с компенсацией ошибки округления (алгоритм ноймайера, вариант суммирования кэхэна)
+struct CompensatedSum {
+    double sum = 0;
+    double compensation = 0; // младшие разряды, потерянные при сложениях
+
+    void add(double value) {
+        double total = sum + value;
+        // теряются разряды меньшего по модулю слагаемого
+        if (fabs(sum) >= fabs(value)) compensation += (sum - total) + value;
+        else compensation += (value - total) + sum;
+        sum = total;
+    }
+
+    double result() const { return sum + compensation; }
+};
+
+// нормы невязки r = A * x - b
+struct ResidualNorms {
+    double l2 = 0;       // евклидова норма ||r||_2
+    double maximum = 0;  // максимальная по модулю компонента ||r||_inf
+    double relative = 0; // ||r||_2 / ||b||_2 (при нулевой правой части - ||r||_2)
+};
+
+// с такого размера невязка считается в несколько потоков (n^2 умножений окупают запуск потоков)
+const int residualParallelSize = 1024;
+
+// точное произведение: a * b = product + error
+inline void twoProduct(double a, double b, double& product, double& error) {
+    product = a * b;
+#if defined(__FMA__)
+    error = fma(a, b, -product);
+#else
+    // разложение деккера: множители делятся на половины по 26 бит, их произведения точны
+    const double split = 134217729.0; // 2^27 + 1
+    double t = split * a;
+    double aHigh = t - (t - a), aLow = a - aHigh;
+    t = split * b;
+    double bHigh = t - (t - b), bLow = b - bHigh;
+    error = ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+#endif
+}
+
+// точная сумма без ветвлений: a + b = sum + error
+inline void twoSum(double a, double b, double& sum, double& error) {
+    sum = a + b;
+    double virtualB = sum - a;
+    error = (a - (sum - virtualB)) + (b - virtualB);
+}
+
+// невязка строки i: a_i * x - b_i скалярным произведением с компенсацией (dot2 огиты-румпа-оиши):
+// ошибки округления произведений и сумм копятся отдельно, результат как при удвоенной точности;
+// четыре независимых накопителя не связывают итерации цепочкой зависимостей,
+// поэтому цикл векторизуется без изменения порядка округлений
+inline double residualComponent(const double* row, const double* solution, double rhs, int size) {
+    double sums[4] = {0, 0, 0, 0};
+    double errors[4] = {0, 0, 0, 0};
+    int j = 0;
+    for (; j + 4 <= size; j += 4) {
+        for (int k = 0; k < 4; ++k) {
+            double product, productError, sumError;
+            twoProduct(row[j + k], solution[j + k], product, productError);
+            twoSum(sums[k], product, sums[k], sumError);
+            errors[k] += productError + sumError;
+        }
+    }
+    CompensatedSum sum;
+    sum.add(-rhs);
+    for (int k = 0; k < 4; ++k) sum.add(sums[k]);
+    double error = errors[0] + errors[1] + errors[2] + errors[3];
+    for (; j < size; ++j) {
+        double product, productError;
+        twoProduct(row[j], solution[j], product, productError);
+        sum.add(product);
+        error += productError;
+    }
+    return sum.result() + error;
+}
+
+// невязка и ее нормы за один проход по матрице: компоненты пишутся в residual
+// (память вызывающего, размер подгоняется только при несовпадении), суммы квадратов
+// накапливаются тут же; большие системы делятся по строкам между threadCount потоками
+// (0 - по числу ядер), частичные суммы складываются в порядке строк
+ResidualNorms computeResidual(const vector<vector<double>>& matrix,
+                              const vector<double>& vectorB,
+                              const vector<double>& solution,
+                              vector<double>& residual,
+                              int threadCount = 0) {
+    LR6_PROFILE_ZONE("computeResidual");
     int size = matrix.size();
-    // создаем вектор для хранения невязки
-    vector<double> residual(size);
-    // перебираем все уравнения системы
-    for (int i = 0; i < size; ++i) {
-        // начинаем с -b[i]
-        residual[i] = -vectorB[i];
-        // добавляем сумму A[i][j]*x[j]
-        for (int j = 0; j < size; ++j) {
-            residual[i] += matrix[i][j] * solution[j];
+    if (int(residual.size()) != size) residual.resize(size);
+    if (size < residualParallelSize) threadCount = 1;
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    threadCount = min(threadCount, max(size, 1));
+
+    // частичные результаты потока
+    struct Partial {
+        CompensatedSum residualSquares;
+        CompensatedSum rhsSquares;
+        double maximum = 0;
+    };
+    vector<Partial> partials(threadCount);
+
+    auto worker = [&](int index) {
+        int first = int(int64_t(size) * index / threadCount);
+        int last = int(int64_t(size) * (index + 1) / threadCount);
+        Partial& partial = partials[index];
+        for (int i = first; i < last; ++i) {
+            double value = residualComponent(matrix[i].data(), solution.data(), vectorB[i], size);
+            residual[i] = value;
+            partial.residualSquares.add(value * value);
+            partial.rhsSquares.add(vectorB[i] * vectorB[i]);
+            partial.maximum = max(partial.maximum, fabs(value));
         }
+    };
+    vector<thread> threads;
+    for (int index = 1; index < threadCount; ++index) threads.emplace_back(worker, index);
+    worker(0);
+    for (auto& t : threads) t.join();
+
+    CompensatedSum residualSquares, rhsSquares;
+    ResidualNorms norms;
+    for (const Partial& partial : partials) {
+        residualSquares.add(partial.residualSquares.result());
+        rhsSquares.add(partial.rhsSquares.result());
+        norms.maximum = max(norms.maximum, partial.maximum);
     }
-    // возвращаем вектор невязки
+    norms.l2 = sqrt(residualSquares.result());
+    double rhsNorm = sqrt(rhsSquares.result());
+    norms.relative = rhsNorm > 0 ? norms.l2 / rhsNorm : norms.l2;
+    return norms;
+}
+
+// функция для вычисления невязки (новый вектор; в циклах лучше computeResidual со своей памятью)
+vector<double> calculateResidual(const vector<vector<double>>& matrix, 
+                               const vector<double>& vectorB, 
+                               const vector<double>& solution) {
+    vector<double> residual;
+    computeResidual(matrix, vectorB, solution, residual);
     return residual;
 }
 
+// максимальная по модулю компонента вектора
+double maxNorm(const vector<double>& vec) {
+    double norm = 0;
+    for (double value : vec) norm = max(norm, fabs(value));
+    return norm;
+}
+
 // метод гаусса с выбором главного элемента
-vector<double> solveGauss(vector<vector<double>> matrix, vector<double> vectorB) {
+vector<double> solveGauss(vector<vector<double>> matrix, vector<double> vectorB, bool verbose = true) {
+    LR6_PROFILE_ZONE("solveGauss");
     // получаем размер системы
     int size = matrix.size();
     // создаем вектор для хранения решения
     vector<double> solution(size, 0);
     
     // выводим заголовок для прямого хода
-    cout << "\nпрямой ход метода гаусса:\n";
+    if (verbose) cout << "\nпрямой ход метода гаусса:\n";
     
     // прямой ход метода (приведение к треугольному виду)
     for (int k = 0; k < size; ++k) {
+        LR6_PROFILE_ZONE("solveGauss: шаг прямого хода");
         // выбор главного элемента в текущем столбце
         int maxRow = k;
         // запоминаем модуль текущего диагонального элемента
@@ -159,7 +309,7 @@ vector<double> solveGauss(vector<vector<double>> matrix, vector<double> vectorB)
             // меняем соответствующие элементы в векторе правой части
             swap(vectorB[k], vectorB[maxRow]);
             // выводим сообщение о перестановке
-            cout << "перестановка строк " << k+1 << " и " << maxRow+1 << endl;
+            if (verbose) cout << "перестановка строк " << k+1 << " и " << maxRow+1 << endl;
         }
         
         // проверка на вырожденность матрицы
@@ -180,34 +330,43 @@ vector<double> solveGauss(vector<vector<double>> matrix, vector<double> vectorB)
         vectorB[k] /= divisor;
         
         // выводим матрицу после нормировки
-        cout << "после нормировки строки " << k+1 << ":\n";
-        printMatrix(matrix);
-        cout << "вектор b: ";
-        printVector(vectorB);
+        if (verbose) {
+            cout << "после нормировки строки " << k+1 << ":\n";
+            printMatrix(matrix);
+            cout << "вектор b: ";
+            printVector(vectorB);
+        }
         
         // исключаем текущую переменную из всех нижних строк
-        for (int i = k + 1; i < size; ++i) {
-            // вычисляем коэффициент для вычитания
-            double factor = matrix[i][k];
-            // вычитаем из текущей строки нормированную строку, умноженную на коэффициент
-            for (int j = k; j < size; ++j) {
-                matrix[i][j] -= factor * matrix[k][j];
+        // (зона профиля закрывается до вывода, чтобы печать не попадала в замер исключения)
+        {
+            LR6_PROFILE_ZONE("solveGauss: исключение");
+            for (int i = k + 1; i < size; ++i) {
+                // вычисляем коэффициент для вычитания
+                double factor = matrix[i][k];
+                // вычитаем из текущей строки нормированную строку, умноженную на коэффициент
+                for (int j = k; j < size; ++j) {
+                    matrix[i][j] -= factor * matrix[k][j];
+                }
+                // аналогично для вектора правой части
+                vectorB[i] -= factor * vectorB[k];
             }
-            // аналогично для вектора правой части
-            vectorB[i] -= factor * vectorB[k];
         }
         
         // выводим матрицу после исключения
-        cout << "после исключения в столбце " << k+1 << ":\n";
-        printMatrix(matrix);
-        cout << "вектор b: ";
-        printVector(vectorB);
+        if (verbose) {
+            cout << "после исключения в столбце " << k+1 << ":\n";
+            printMatrix(matrix);
+            cout << "вектор b: ";
+            printVector(vectorB);
+        }
     }
     
     // выводим заголовок для обратного хода
-    cout << "\nобратный ход метода гаусса:\n";
+    if (verbose) cout << "\nобратный ход метода гаусса:\n";
     
     // обратный ход (нахождение решения)
+    LR6_PROFILE_ZONE("solveGauss: обратный ход");
     for (int k = size - 1; k >= 0; --k) {
         // начинаем с элемента вектора правой части
         solution[k] = vectorB[k];
@@ -216,64 +375,145 @@ vector<double> solveGauss(vector<vector<double>> matrix, vector<double> vectorB)
             solution[k] -= matrix[k][j] * solution[j];
         }
         // выводим найденное значение переменной
-        cout << "x[" << k+1 << "] = " << solution[k] << endl;
+        if (verbose) cout << "x[" << k+1 << "] = " << solution[k] << endl;
     }
     
     // возвращаем полученное решение
     return solution;
 }
 
+// состояние итерационного решателя, сохраняемое между шагами по времени
+struct IterativeSolverState {
+    vector<double> inverseDiagonal; // обратные диагональные элементы 1 / a_ii
+    vector<double> solution;        // последнее решение - начальное приближение для следующего шага
+    int lastIterations = 0;         // число итераций последнего решения
+};
+
+// подготовка состояния: обратная диагональ и нулевое начальное приближение
+bool initSolverState(const vector<vector<double>>& matrix, IterativeSolverState& state) {
+    int size = matrix.size();
+    state.inverseDiagonal.assign(size, 0.0);
+    for (int i = 0; i < size; ++i) {
+        if (matrix[i][i] == 0) {
+            cerr << "нулевой диагональный элемент в строке " << i + 1 << endl;
+            return false;
+        }
+        state.inverseDiagonal[i] = 1.0 / matrix[i][i];
+    }
+    // прежнее решение сохраняем, если размер не изменился
+    if (int(state.solution.size()) != size) state.solution.assign(size, 0.0);
+    state.lastIterations = 0;
+    return true;
+}
+
+// изменение одного элемента матрицы с обновлением производных данных
+bool updateMatrixEntry(vector<vector<double>>& matrix, IterativeSolverState& state,
+                       int row, int col, double value) {
+    if (row == col && value == 0) {
+        cerr << "нулевой диагональный элемент в строке " << row + 1 << endl;
+        return false;
+    }
+    matrix[row][col] = value;
+    if (row == col) state.inverseDiagonal[row] = 1.0 / value;
+    return true;
+}
+
+// замена строки матрицы с обновлением производных данных
+bool updateMatrixRow(vector<vector<double>>& matrix, IterativeSolverState& state,
+                     int row, const vector<double>& values) {
+    if (int(values.size()) != int(matrix.size())) {
+        cerr << "длина строки (" << values.size() << ") не совпадает с размером матрицы ("
+             << matrix.size() << ")" << endl;
+        return false;
+    }
+    if (values[row] == 0) {
+        cerr << "нулевой диагональный элемент в строке " << row + 1 << endl;
+        return false;
+    }
+    matrix[row] = values;
+    state.inverseDiagonal[row] = 1.0 / values[row];
+    return true;
+}
+
+// начальное приближение итерационного метода: заданное, решение из состояния или нули
+vector<double> initialSolution(int size, const vector<double>* initialGuess,
+                               const IterativeSolverState* state) {
+    if (initialGuess && int(initialGuess->size()) == size) return *initialGuess;
+    if (state && int(state->solution.size()) == size) return state->solution;
+    return vector<double>(size, 0);
+}
+
 // метод якоби для решения системы
+// (initialGuess - начальное приближение; state - сохраняемое состояние: его обратная диагональ
+// используется вместо деления, а решение и число итераций записываются обратно)
 vector<double> solveJacobi(const vector<vector<double>>& matrix, 
                          const vector<double>& vectorB, 
                          double epsilon, 
-                         int maxIterations = 100) {
+                         int maxIterations = 100,
+                         bool verbose = true,
+                         int* iterationsOut = nullptr,
+                         vector<ResidualNorms>* residualHistory = nullptr,
+                         const vector<double>* initialGuess = nullptr,
+                         IterativeSolverState* state = nullptr) {
+    LR6_PROFILE_ZONE("solveJacobi");
     // получаем размер системы
     int size = matrix.size();
-    // создаем вектор для решения (начальное приближение - нули)
-    vector<double> solution(size, 0);
+    // создаем вектор для решения (начальное приближение - нули, если не задано другое)
+    vector<double> solution = initialSolution(size, initialGuess, state);
+    // обратная диагональ из состояния, если оно передано и подготовлено для этой матрицы
+    const double* inverseDiagonal =
+        state && int(state->inverseDiagonal.size()) == size ? state->inverseDiagonal.data() : nullptr;
     // вектор для новых значений на следующей итерации
     vector<double> newSolution(size);
+    // память под невязку для наблюдения за сходимостью (выделяется один раз)
+    vector<double> residual;
     // счетчик итераций
     int iterations = 0;
     // переменная для хранения погрешности
     double error;
     
     // выводим заголовок для итерационного процесса
-    cout << "\nметод якоби (начальное приближение - нулевое):\n";
-    cout << "n\tx1\t\tx2\t\tx3\t\tx4\t\tεn\n";
+    if (verbose) {
+        cout << "\nметод якоби (начальное приближение - "
+             << (initialGuess || state ? "заданное" : "нулевое") << "):\n";
+        cout << "n\tx1\t\tx2\t\tx3\t\tx4\t\tεn\n";
+    }
     
     // основной итерационный цикл
     do {
+        // погрешность - максимальное изменение между итерациями, считается в том же проходе
+        error = 0;
         // вычисляем новые значения для каждой переменной
         for (int i = 0; i < size; ++i) {
-            // сумма для i-го уравнения
+            // сумма для i-го уравнения (указатель на строку берем один раз, иначе компилятор
+            // перечитывает его внутри цикла)
+            const double* row = matrix[i].data();
             double sum = 0;
             // перебираем все переменные кроме текущей
             for (int j = 0; j < size; ++j) {
-                if (j != i) sum += matrix[i][j] * solution[j];
+                if (j != i) sum += row[j] * solution[j];
             }
             // вычисляем новое значение переменной
-            newSolution[i] = (vectorB[i] - sum) / matrix[i][i];
-        }
-        
-        // вычисляем погрешность как максимальное изменение между итерациями
-        error = 0;
-        for (int i = 0; i < size; ++i) {
+            newSolution[i] = inverseDiagonal ? (vectorB[i] - sum) * inverseDiagonal[i]
+                                             : (vectorB[i] - sum) / row[i];
             error = max(error, fabs(newSolution[i] - solution[i]));
         }
         
-        // выводим номер текущей итерации
-        cout << iterations << "\t";
-        // выводим значения переменных с точностью 6 знаков после запятой
-        for (int i = 0; i < size; ++i) {
-            cout << fixed << setprecision(6) << newSolution[i] << "\t";
+        // выводим номер текущей итерации, значения переменных и погрешность
+        if (verbose) {
+            cout << iterations << "\t";
+            // выводим значения переменных с точностью 6 знаков после запятой
+            for (int i = 0; i < size; ++i) {
+                cout << fixed << setprecision(6) << newSolution[i] << "\t";
+            }
+            // выводим текущую погрешность
+            cout << error << endl;
         }
-        // выводим текущую погрешность
-        cout << error << endl;
         
-        // обновляем решение
-        solution = newSolution;
+        // обновляем решение (обмен без копирования)
+        solution.swap(newSolution);
+        // нормы невязки нового приближения, если их просили
+        if (residualHistory) residualHistory->push_back(computeResidual(matrix, vectorB, solution, residual));
         // увеличиваем счетчик итераций
         iterations++;
         
@@ -286,60 +526,85 @@ vector<double> solveJacobi(const vector<vector<double>>& matrix,
         }
     } while (error > epsilon); // условие продолжения итераций
     
+    // сообщаем вызывающему количество выполненных итераций
+    if (iterationsOut) *iterationsOut = iterations;
+    // сохраняем решение как начальное приближение для следующего шага
+    if (state) {
+        state->solution = solution;
+        state->lastIterations = iterations;
+    }
     // возвращаем полученное решение
     return solution;
 }
 
-// метод гаусса-зейделя для решения системы
+// метод гаусса-зейделя для решения системы (initialGuess и state - как у метода якоби)
 vector<double> solveSeidel(const vector<vector<double>>& matrix, 
                          const vector<double>& vectorB, 
                          double epsilon, 
-                         int maxIterations = 100) {
+                         int maxIterations = 100,
+                         bool verbose = true,
+                         int* iterationsOut = nullptr,
+                         vector<ResidualNorms>* residualHistory = nullptr,
+                         const vector<double>* initialGuess = nullptr,
+                         IterativeSolverState* state = nullptr) {
+    LR6_PROFILE_ZONE("solveSeidel");
     // получаем размер системы
     int size = matrix.size();
-    // создаем вектор для решения (начальное приближение - нули)
-    vector<double> solution(size, 0);
+    // создаем вектор для решения (начальное приближение - нули, если не задано другое)
+    vector<double> solution = initialSolution(size, initialGuess, state);
+    // обратная диагональ из состояния, если оно передано и подготовлено для этой матрицы
+    const double* inverseDiagonal =
+        state && int(state->inverseDiagonal.size()) == size ? state->inverseDiagonal.data() : nullptr;
     // счетчик итераций
     int iterations = 0;
     // переменная для хранения погрешности
     double error;
+    // память под невязку для наблюдения за сходимостью (выделяется один раз)
+    vector<double> residual;
     
     // выводим заголовок для итерационного процесса
-    cout << "\nметод гаусса-зейделя (начальное приближение - нулевое):\n";
-    cout << "n\tx1\t\tx2\t\tx3\t\tx4\t\tεn\n";
+    if (verbose) {
+        cout << "\nметод гаусса-зейделя (начальное приближение - "
+             << (initialGuess || state ? "заданное" : "нулевое") << "):\n";
+        cout << "n\tx1\t\tx2\t\tx3\t\tx4\t\tεn\n";
+    }
     
     // основной итерационный цикл
     do {
         // сбрасываем погрешность перед новой итерацией
         error = 0;
-        // сохраняем старое решение для сравнения
-        vector<double> oldSolution = solution;
         
         // вычисляем новые значения переменных
         for (int i = 0; i < size; ++i) {
-            // сумма для i-го уравнения
+            // сумма для i-го уравнения (указатель на строку берем один раз)
+            const double* row = matrix[i].data();
             double sum = 0;
             // используем уже обновленные значения переменных
             for (int j = 0; j < size; ++j) {
-                if (j != i) sum += matrix[i][j] * solution[j];
+                if (j != i) sum += row[j] * solution[j];
             }
             // вычисляем новое значение переменной
-            double newValue = (vectorB[i] - sum) / matrix[i][i];
+            double newValue = inverseDiagonal ? (vectorB[i] - sum) * inverseDiagonal[i]
+                                              : (vectorB[i] - sum) / row[i];
             // обновляем погрешность
             error = max(error, fabs(newValue - solution[i]));
             // сразу записываем новое значение
             solution[i] = newValue;
         }
         
-        // выводим номер текущей итерации
-        cout << iterations << "\t";
-        // выводим значения переменных с точностью 6 знаков после запятой
-        for (int i = 0; i < size; ++i) {
-            cout << fixed << setprecision(6) << solution[i] << "\t";
+        // выводим номер текущей итерации, значения переменных и погрешность
+        if (verbose) {
+            cout << iterations << "\t";
+            // выводим значения переменных с точностью 6 знаков после запятой
+            for (int i = 0; i < size; ++i) {
+                cout << fixed << setprecision(6) << solution[i] << "\t";
+            }
+            // выводим текущую погрешность
+            cout << error << endl;
         }
-        // выводим текущую погрешность
-        cout << error << endl;
         
+        // нормы невязки нового приближения, если их просили
+        if (residualHistory) residualHistory->push_back(computeResidual(matrix, vectorB, solution, residual));
         // увеличиваем счетчик итераций
         iterations++;
         // проверяем, не превышен ли лимит итераций
@@ -351,12 +616,1621 @@ vector<double> solveSeidel(const vector<vector<double>>& matrix,
         }
     } while (error > epsilon); // условие продолжения итераций
     
+    // сообщаем вызывающему количество выполненных итераций
+    if (iterationsOut) *iterationsOut = iterations;
+    // сохраняем решение как начальное приближение для следующего шага
+    if (state) {
+        state->solution = solution;
+        state->lastIterations = iterations;
+    }
     // возвращаем полученное решение
     return solution;
 }
 
+// метод сопряженных градиентов для симметричных положительно определенных систем
+vector<double> solveConjugateGradient(const vector<vector<double>>& matrix,
+                                      const vector<double>& vectorB,
+                                      double epsilon,
+                                      int maxIterations = 100,
+                                      bool verbose = true,
+                                      int* iterationsOut = nullptr,
+                                      bool* failedOut = nullptr) {
+    // получаем размер системы
+    int size = matrix.size();
+    // начальное приближение - нули, поэтому невязка r = b и направление p = r
+    vector<double> solution(size, 0);
+    vector<double> residual = vectorB;
+    vector<double> direction = residual;
+    vector<double> product(size);
+    double residualSquare = 0;
+    for (double value : residual) residualSquare += value * value;
+    int iterations = 0;
+    bool failed = false;
+
+    if (verbose) {
+        cout << "\nметод сопряженных градиентов (начальное приближение - нулевое):\n";
+        cout << "n\tнорма невязки\n";
+    }
+
+    // итерируем, пока максимальная компонента невязки больше epsilon
+    while (maxNorm(residual) > epsilon) {
+        // лимит итераций: решение не сошлось, вызывающий должен об этом узнать
+        if (iterations >= maxIterations) {
+            cerr << "достигнут лимит итераций!" << endl;
+            failed = true;
+            break;
+        }
+        // q = A * p и шаг alpha = (r, r) / (p, A p)
+        double curvature = 0;
+        for (int i = 0; i < size; ++i) {
+            double sum = 0;
+            for (int j = 0; j < size; ++j) sum += matrix[i][j] * direction[j];
+            product[i] = sum;
+            curvature += direction[i] * sum;
+        }
+        // неположительная кривизна: матрица не положительно определена
+        if (curvature <= 0) {
+            failed = true;
+            break;
+        }
+        double alpha = residualSquare / curvature;
+        // обновляем решение и невязку
+        double newResidualSquare = 0;
+        for (int i = 0; i < size; ++i) {
+            solution[i] += alpha * direction[i];
+            residual[i] -= alpha * product[i];
+            newResidualSquare += residual[i] * residual[i];
+        }
+        // новое сопряженное направление
+        double beta = newResidualSquare / residualSquare;
+        for (int i = 0; i < size; ++i) {
+            direction[i] = residual[i] + beta * direction[i];
+        }
+        residualSquare = newResidualSquare;
+        iterations++;
+
+        if (verbose) {
+            cout << iterations << "\t" << scientific << setprecision(6) << sqrt(residualSquare) << endl;
+            cout.unsetf(ios::floatfield);
+        }
+    }
+
+    // сообщаем вызывающему количество итераций и признак неудачи
+    // (неположительная кривизна или несходимость за maxIterations итераций)
+    if (iterationsOut) *iterationsOut = iterations;
+    if (failedOut) *failedOut = failed;
+    return solution;
+}
+
+// ленточная матрица: в строке i хранятся столбцы от i - lower до i + upper + lower
+// (lower лишних диагоналей сверху нужны под заполнение при перестановках строк)
+struct BandMatrix {
+    int size = 0;        // размер матрицы
+    int lower = 0;       // ширина ленты ниже диагонали
+    int upper = 0;       // ширина ленты выше диагонали
+    int stride = 0;      // число хранимых элементов в строке
+    vector<double> data; // элементы ленты по строкам
+
+    // выделяем память под ленту заданной ширины
+    void assign(int newSize, int newLower, int newUpper) {
+        size = newSize;
+        lower = newLower;
+        upper = newUpper;
+        stride = 2 * lower + upper + 1;
+        data.assign(size_t(size) * stride, 0.0);
+    }
+
+    // элемент (i, j), столбец j должен лежать в хранимой части строки i
+    double& at(int i, int j) { return data[size_t(i) * stride + (j - i + lower)]; }
+    double at(int i, int j) const { return data[size_t(i) * stride + (j - i + lower)]; }
+};
+
+// перенос ленты плотной матрицы в ленточное хранение
+BandMatrix denseToBand(const vector<vector<double>>& matrix, int lower, int upper) {
+    BandMatrix band;
+    int size = matrix.size();
+    band.assign(size, lower, upper);
+    for (int i = 0; i < size; ++i) {
+        for (int j = max(0, i - lower); j <= min(size - 1, i + upper); ++j) {
+            band.at(i, j) = matrix[i][j];
+        }
+    }
+    return band;
+}
+
+// невязка A*x - b для ленточной матрицы
+vector<double> calculateBandResidual(const BandMatrix& band,
+                                     const vector<double>& vectorB,
+                                     const vector<double>& solution) {
+    vector<double> residual(band.size);
+    for (int i = 0; i < band.size; ++i) {
+        double sum = -vectorB[i];
+        for (int j = max(0, i - band.lower); j <= min(band.size - 1, i + band.upper); ++j) {
+            sum += band.at(i, j) * solution[j];
+        }
+        residual[i] = sum;
+    }
+    return residual;
+}
+
+// метод гаусса для ленточной матрицы с выбором главного элемента в столбце:
+// O(n * lower * (lower + upper)) операций и O(n * (2 lower + upper)) памяти
+vector<double> solveBanded(BandMatrix band, vector<double> vectorB) {
+    LR6_PROFILE_ZONE("solveBanded");
+    int size = band.size;
+    // после перестановок строка может заполниться до lower + upper элементов правее диагонали
+    int reach = band.lower + band.upper;
+
+    // прямой ход
+    for (int k = 0; k < size; ++k) {
+        int lastRow = min(size - 1, k + band.lower);
+        int lastColumn = min(size - 1, k + reach);
+        // выбор главного элемента среди строк, задевающих столбец k
+        int maxRow = k;
+        double maxValue = fabs(band.at(k, k));
+        for (int i = k + 1; i <= lastRow; ++i) {
+            if (fabs(band.at(i, k)) > maxValue) {
+                maxValue = fabs(band.at(i, k));
+                maxRow = i;
+            }
+        }
+        if (maxValue < 1e-10) {
+            cerr << "матрица вырожденная!" << endl;
+            exit(1);
+        }
+        // переставляем только хранимые части строк
+        if (maxRow != k) {
+            for (int j = k; j <= lastColumn; ++j) swap(band.at(k, j), band.at(maxRow, j));
+            swap(vectorB[k], vectorB[maxRow]);
+        }
+        // исключаем переменную из строк ниже в пределах ленты
+        double pivot = band.at(k, k);
+        for (int i = k + 1; i <= lastRow; ++i) {
+            double factor = band.at(i, k) / pivot;
+            if (factor == 0) continue;
+            band.at(i, k) = 0;
+            for (int j = k + 1; j <= lastColumn; ++j) {
+                band.at(i, j) -= factor * band.at(k, j);
+            }
+            vectorB[i] -= factor * vectorB[k];
+        }
+    }
+
+    // обратный ход
+    vector<double> solution(size, 0);
+    for (int k = size - 1; k >= 0; --k) {
+        double sum = vectorB[k];
+        for (int j = k + 1; j <= min(size - 1, k + reach); ++j) {
+            sum -= band.at(k, j) * solution[j];
+        }
+        solution[k] = sum / band.at(k, k);
+    }
+    return solution;
+}
+
+// проверка, можно ли решать трехдиагональную систему прогонкой без выбора главного элемента
+bool isStableTridiagonal(const BandMatrix& band) {
+    if (band.lower > 1 || band.upper > 1) return false;
+    bool strictRow = false;
+    for (int i = 0; i < band.size; ++i) {
+        double sum = 0;
+        if (i > 0) sum += fabs(band.at(i, i - 1));
+        if (i + 1 < band.size) sum += fabs(band.at(i, i + 1));
+        double diagonal = fabs(band.at(i, i));
+        // нестрогое преобладание со строгим хотя бы в одной строке
+        if (diagonal < sum || diagonal == 0) return false;
+        if (diagonal > sum) strictRow = true;
+    }
+    return strictRow;
+}
+
+// метод прогонки (томаса) для трехдиагональной матрицы: O(n) операций
+vector<double> solveTridiagonal(const BandMatrix& band, const vector<double>& vectorB) {
+    LR6_PROFILE_ZONE("solveTridiagonal");
+    int size = band.size;
+    // прогоночные коэффициенты: x[i] = alpha[i] - beta[i] * x[i+1]
+    vector<double> beta(size);
+    vector<double> alpha(size);
+    double denominator = band.at(0, 0);
+    beta[0] = size > 1 ? band.at(0, 1) / denominator : 0;
+    alpha[0] = vectorB[0] / denominator;
+    // прямая прогонка
+    for (int i = 1; i < size; ++i) {
+        double subDiagonal = band.at(i, i - 1);
+        denominator = band.at(i, i) - subDiagonal * beta[i - 1];
+        if (fabs(denominator) < 1e-300) {
+            cerr << "матрица вырожденная!" << endl;
+            exit(1);
+        }
+        beta[i] = i + 1 < size ? band.at(i, i + 1) / denominator : 0;
+        alpha[i] = (vectorB[i] - subDiagonal * alpha[i - 1]) / denominator;
+    }
+    // обратная прогонка
+    vector<double> solution(size);
+    solution[size - 1] = alpha[size - 1];
+    for (int i = size - 2; i >= 0; --i) {
+        solution[i] = alpha[i] - beta[i] * solution[i + 1];
+    }
+    return solution;
+}
+
+// решение ленточной системы: прогонка для устойчивых трехдиагональных, иначе ленточный гаусс
+vector<double> solveBandSystem(const BandMatrix& band, const vector<double>& vectorB) {
+    if (band.size == 0) return {};
+    if (isStableTridiagonal(band)) return solveTridiagonal(band, vectorB);
+    return solveBanded(band, vectorB);
+}
+
+// структурные характеристики матрицы для выбора метода
+struct MatrixAnalysis {
+    int size = 0;                   // размер матрицы
+    long long nonZeros = 0;         // число ненулевых элементов
+    double density = 0;             // доля ненулевых элементов
+    int lowerBandwidth = 0;         // ширина ленты ниже диагонали
+    int upperBandwidth = 0;         // ширина ленты выше диагонали
+    bool symmetric = true;          // симметричность
+    bool positiveDiagonal = true;   // все диагональные элементы положительны
+    bool zeroDiagonal = false;      // есть нулевой диагональный элемент
+    bool diagonallyDominant = true; // строгое диагональное преобладание во всех строках
+    int weakRows = 0;               // строки без строгого преобладания
+    double dominanceMargin = 0;     // min (|a_ii| - сумма |a_ij|) / |a_ii| по строкам
+    double matrixNorm = 0;          // бесконечная норма матрицы
+    bool positiveDefinite = false;  // доказано: симметричная, все круги гершгорина правее нуля
+    bool likelyPositiveDefinite = false; // только признак: наименьшее значение ритца ланцоша > 0
+    double conditionEstimate = 0;   // оценка числа обусловленности (inf - неизвестно)
+    bool conditionLowerBound = false; // оценка по ланцошу - снизу, настоящее число может быть больше
+};
+
+// шагов ланцоша для оценки крайних собственных значений
+const int lanczosSteps = 30;
+
+// крайние собственные значения симметричной матрицы по steps шагам ланцоша (steps умножений
+// на матрицу): значения ритца приближают края спектра изнутри, lowest >= lambda_min и
+// highest <= lambda_max, поэтому highest / lowest - оценка числа обусловленности снизу
+void estimateExtremeEigenvalues(const vector<vector<double>>& matrix, int steps,
+                                double& lowest, double& highest) {
+    int size = matrix.size();
+    lowest = highest = 0;
+    if (size == 0) return;
+    // начальный вектор - случайный с фиксированным seed, чтобы анализ был воспроизводимым
+    mt19937_64 generator(20240601);
+    uniform_real_distribution<double> component(-1.0, 1.0);
+    vector<double> previous(size, 0.0), current(size), next(size);
+    double norm = 0;
+    for (double& value : current) {
+        value = component(generator);
+        norm += value * value;
+    }
+    norm = sqrt(norm);
+    for (double& value : current) value /= norm;
+
+    // трехдиагональная матрица ланцоша: alpha - диагональ, beta - поддиагональ
+    vector<double> alpha, beta;
+    double previousBeta = 0;
+    for (int step = 0; step < steps; ++step) {
+        double a = 0;
+        for (int i = 0; i < size; ++i) {
+            double sum = 0;
+            for (int j = 0; j < size; ++j) sum += matrix[i][j] * current[j];
+            next[i] = sum - previousBeta * previous[i];
+            a += current[i] * next[i];
+        }
+        alpha.push_back(a);
+        double b = 0;
+        for (int i = 0; i < size; ++i) {
+            next[i] -= a * current[i];
+            b += next[i] * next[i];
+        }
+        b = sqrt(b);
+        // инвариантное подпространство: найденные значения ритца точные
+        if (step + 1 == steps || b <= 1e-12 * fabs(a)) break;
+        beta.push_back(b);
+        for (int i = 0; i < size; ++i) {
+            previous[i] = current[i];
+            current[i] = next[i] / b;
+        }
+        previousBeta = b;
+    }
+
+    // собственные значения трехдиагональной матрицы - бисекцией по числу перемен знака (штурм)
+    int m = alpha.size();
+    auto countBelow = [&](double x) {
+        int count = 0;
+        double d = 1;
+        for (int i = 0; i < m; ++i) {
+            d = alpha[i] - x - (i ? beta[i - 1] * beta[i - 1] / d : 0.0);
+            if (d == 0) d = -1e-300;
+            if (d < 0) count++;
+        }
+        return count;
+    };
+    double low = INFINITY, high = -INFINITY;
+    for (int i = 0; i < m; ++i) {
+        double radius = (i ? beta[i - 1] : 0.0) + (i + 1 < m ? beta[i] : 0.0);
+        low = min(low, alpha[i] - radius);
+        high = max(high, alpha[i] + radius);
+    }
+    // k-е по возрастанию собственное значение: наименьшее x, ниже которого k значений
+    auto eigenvalue = [&](int k) {
+        double left = low, right = high;
+        for (int iteration = 0; iteration < 200 && right - left > 1e-15 * max(fabs(left), fabs(right)); ++iteration) {
+            double middle = 0.5 * (left + right);
+            if (countBelow(middle) >= k) right = middle;
+            else left = middle;
+        }
+        return 0.5 * (left + right);
+    };
+    lowest = eigenvalue(1);
+    highest = eigenvalue(m);
+}
+
+// анализ матрицы за один проход: преобладание, симметрия, разреженность, лента, обусловленность
+MatrixAnalysis analyzeMatrix(const vector<vector<double>>& matrix) {
+    MatrixAnalysis analysis;
+    int size = matrix.size();
+    analysis.size = size;
+    analysis.dominanceMargin = size ? 1.0 : 0.0;
+    // наименьший запас преобладания и нижняя граница гершгорина
+    double minGap = INFINITY;
+    double gershgorinLow = INFINITY;
+
+    for (int i = 0; i < size; ++i) {
+        const vector<double>& row = matrix[i];
+        double offDiagonalSum = 0;
+        for (int j = 0; j < size; ++j) {
+            double value = row[j];
+            // симметрию проверяем по парам (i, j) и (j, i) верхнего треугольника, пока она не нарушится;
+            // до пропуска нулей, иначе не заметим нуль в паре с ненулевым элементом
+            if (j > i && analysis.symmetric &&
+                fabs(value - matrix[j][i]) > 1e-12 * max(fabs(value), fabs(matrix[j][i]))) {
+                analysis.symmetric = false;
+            }
+            if (value == 0) continue;
+            analysis.nonZeros++;
+            if (j < i) analysis.lowerBandwidth = max(analysis.lowerBandwidth, i - j);
+            if (j > i) analysis.upperBandwidth = max(analysis.upperBandwidth, j - i);
+            if (j != i) offDiagonalSum += fabs(value);
+        }
+        double diagonal = row[i];
+        if (diagonal <= 0) analysis.positiveDiagonal = false;
+        if (diagonal == 0) analysis.zeroDiagonal = true;
+        if (fabs(diagonal) <= offDiagonalSum) {
+            analysis.diagonallyDominant = false;
+            analysis.weakRows++;
+        }
+        analysis.dominanceMargin = min(analysis.dominanceMargin,
+            diagonal == 0 ? -INFINITY : (fabs(diagonal) - offDiagonalSum) / fabs(diagonal));
+        minGap = min(minGap, fabs(diagonal) - offDiagonalSum);
+        gershgorinLow = min(gershgorinLow, diagonal - offDiagonalSum);
+        analysis.matrixNorm = max(analysis.matrixNorm, fabs(diagonal) + offDiagonalSum);
+    }
+    analysis.density = size ? double(analysis.nonZeros) / (double(size) * size) : 0;
+
+    // симметричная матрица с преобладанием и положительной диагональю положительно определена
+    // (все круги гершгорина в правой полуплоскости)
+    if (analysis.symmetric && analysis.positiveDiagonal && gershgorinLow > 0) analysis.positiveDefinite = true;
+
+    // оценка обусловленности: граница варах для преобладающих матриц
+    // (||A^-1|| <= 1 / min(|a_ii| - r_i)), для остальных симметричных с положительной диагональю -
+    // отношение крайних собственных значений по нескольким шагам ланцоша
+    if (analysis.diagonallyDominant && minGap > 0) {
+        analysis.conditionEstimate = analysis.matrixNorm / minGap;
+    } else if (analysis.symmetric && analysis.positiveDiagonal) {
+        double lowest, highest;
+        estimateExtremeEigenvalues(matrix, min(size, lanczosSteps), lowest, highest);
+        // неположительное значение ритца доказывает, что матрица не положительно определена;
+        // положительное - только признак: lowest >= lambda_min, и lambda_min может быть <= 0
+        analysis.likelyPositiveDefinite = lowest > 0;
+        analysis.conditionEstimate = lowest > 0 ? highest / lowest : INFINITY;
+        analysis.conditionLowerBound = lowest > 0;
+    } else {
+        analysis.conditionEstimate = INFINITY;
+    }
+    return analysis;
+}
+
+// методы, между которыми выбирает анализатор
+// (якоби среди них нет: итерация стоит столько же, сколько у зейделя, а при строгом
+// диагональном преобладании зейдель сходится не медленнее, так что якоби никогда не дешевле)
+enum class SolverMethod { Gauss, Banded, Seidel, ConjugateGradient };
+
+// выбранный метод и обоснование выбора
+struct SolverChoice {
+    SolverMethod method = SolverMethod::Gauss;
+    double estimatedFlops = 0; // оценка числа операций
+    string reason;             // почему выбран этот метод
+};
+
+// название метода для вывода
+const char* solverMethodName(SolverMethod method) {
+    switch (method) {
+        case SolverMethod::Gauss:             return "гаусса";
+        case SolverMethod::Banded:            return "ленточный гаусса";
+        case SolverMethod::Seidel:            return "гаусса-зейделя";
+        case SolverMethod::ConjugateGradient: return "сопряженных градиентов";
+    }
+    return "неизвестный";
+}
+
+// выбор самого дешевого метода, который должен сойтись
+SolverChoice chooseSolver(const MatrixAnalysis& analysis, double epsilon, int maxIterations) {
+    double n = analysis.size;
+    // прямой метод сходится всегда, его стоимость ~2n^3/3
+    SolverChoice choice;
+    choice.method = SolverMethod::Gauss;
+    choice.estimatedFlops = 2.0 * n * n * n / 3.0;
+    choice.reason = "прямой метод: нет гарантий сходимости итерационных методов";
+    string directName = "прямой метод";
+
+    // ленточный метод тоже прямой, но работает только внутри ленты: ~2n * lower * (lower + upper)
+    double lower = analysis.lowerBandwidth;
+    double upper = analysis.upperBandwidth;
+    if (lower + upper < n - 1) {
+        double bandFlops = 2.0 * n * (lower + 1) * (lower + upper + 1);
+        if (bandFlops < choice.estimatedFlops) {
+            choice.method = SolverMethod::Banded;
+            choice.estimatedFlops = bandFlops;
+            ostringstream bandReason;
+            bandReason << "ленточная матрица (" << lower << " ниже и " << upper
+                       << " выше диагонали): прямой ленточный метод";
+            choice.reason = bandReason.str();
+            directName = "ленточный метод";
+        }
+    }
+
+    double iterationFlops = 2.0 * n * n;
+    double tolerance = max(epsilon, 1e-15);
+    ostringstream reason;
+
+    if (analysis.diagonallyDominant && analysis.dominanceMargin > 0) {
+        // ||B||_inf <= 1 - margin для матрицы итераций якоби; зейдель сходится не медленнее
+        double rate = 1.0 - analysis.dominanceMargin;
+        double iterations = rate > 0 ? ceil(log(tolerance) / log(rate)) : 1.0;
+        double flops = iterations * iterationFlops;
+        if (iterations <= maxIterations && flops < choice.estimatedFlops) {
+            choice.method = SolverMethod::Seidel;
+            choice.estimatedFlops = flops;
+            reason << "строгое диагональное преобладание (запас " << analysis.dominanceMargin
+                   << "), ожидается не более " << iterations << " итераций";
+            choice.reason = reason.str();
+            return choice;
+        }
+        reason << "преобладание есть (запас " << analysis.dominanceMargin << "), но при "
+               << iterations << " ожидаемых итерациях " << directName << " дешевле";
+        choice.reason = reason.str();
+        return choice;
+    }
+
+    if (analysis.positiveDefinite || analysis.likelyPositiveDefinite) {
+        // для сопряженных градиентов число итераций ~ sqrt(cond) * ln(2/eps) / 2, но не больше n;
+        // оценка обусловленности по ланцошу занижена, поэтому число итераций берем с запасом вдвое
+        double iterations = n;
+        if (isfinite(analysis.conditionEstimate)) {
+            double margin = analysis.conditionLowerBound ? 2.0 : 1.0;
+            iterations = min(n, ceil(margin * sqrt(analysis.conditionEstimate) * log(2.0 / tolerance) / 2.0));
+        }
+        double flops = iterations * iterationFlops;
+        if (iterations <= maxIterations && flops < choice.estimatedFlops) {
+            choice.method = SolverMethod::ConjugateGradient;
+            choice.estimatedFlops = flops;
+            if (analysis.positiveDefinite) reason << "симметричная положительно определенная матрица";
+            else reason << "симметричная матрица, по оценке ланцоша положительно определенная";
+            reason << ", ожидается около " << iterations << " итераций крылова"
+                   << " (при неудаче - переход к методу гаусса)";
+            choice.reason = reason.str();
+            return choice;
+        }
+        reason << "симметричная матрица, но при " << iterations
+               << " ожидаемых итерациях крылова " << directName << " дешевле";
+        choice.reason = reason.str();
+        return choice;
+    }
+
+    // ленточный метод уже выбран со своим обоснованием
+    if (choice.method == SolverMethod::Banded) return choice;
+    if (analysis.zeroDiagonal) {
+        choice.reason = "нулевой диагональный элемент: нужен прямой метод с выбором главного элемента";
+    } else if (analysis.symmetric) {
+        choice.reason = "симметричная, но не положительно определенная матрица: прямой метод";
+    } else if (!analysis.diagonallyDominant) {
+        reason << "нет диагонального преобладания в " << analysis.weakRows
+               << " строках и нет симметрии: прямой метод";
+        choice.reason = reason.str();
+    }
+    return choice;
+}
+
+// вывод результатов анализа и выбранного метода
+void printAnalysis(const MatrixAnalysis& analysis, const SolverChoice& choice) {
+    cout << "анализ матрицы:\n"
+         << "  размер: " << analysis.size << ", ненулевых: " << analysis.nonZeros
+         << " (доля " << analysis.density << ")\n"
+         << "  лента: " << analysis.lowerBandwidth << " ниже и "
+         << analysis.upperBandwidth << " выше диагонали\n"
+         << "  симметричная: " << (analysis.symmetric ? "да" : "нет")
+         << ", положительная диагональ: " << (analysis.positiveDiagonal ? "да" : "нет")
+         << ", положительно определенная: "
+         << (analysis.positiveDefinite ? "да" : analysis.likelyPositiveDefinite ? "вероятно (по оценке ланцоша)" : "нет")
+         << "\n"
+         << "  диагональное преобладание: " << (analysis.diagonallyDominant ? "да" : "нет")
+         << ", запас " << analysis.dominanceMargin << ", строк без преобладания: "
+         << analysis.weakRows << "\n"
+         << "  оценка числа обусловленности: ";
+    if (isfinite(analysis.conditionEstimate)) {
+        cout << (analysis.conditionLowerBound ? "не меньше " : "") << analysis.conditionEstimate << "\n";
+    }
+    else cout << "неизвестна\n";
+    cout << "выбран метод " << solverMethodName(choice.method) << ": " << choice.reason << endl;
+}
+
+// решение системы методом, выбранным по структуре матрицы
+vector<double> solveAutomatic(const vector<vector<double>>& matrix,
+                              const vector<double>& vectorB,
+                              double epsilon,
+                              int maxIterations = 100,
+                              bool verbose = true) {
+    MatrixAnalysis analysis = analyzeMatrix(matrix);
+    SolverChoice choice = chooseSolver(analysis, epsilon, maxIterations);
+    printAnalysis(analysis, choice);
+
+    switch (choice.method) {
+        case SolverMethod::Banded:
+            return solveBandSystem(denseToBand(matrix, analysis.lowerBandwidth, analysis.upperBandwidth),
+                                   vectorB);
+        case SolverMethod::Seidel:
+            return solveSeidel(matrix, vectorB, epsilon, maxIterations, verbose);
+        case SolverMethod::ConjugateGradient: {
+            bool failed = false;
+            int iterations = 0;
+            vector<double> solution = solveConjugateGradient(matrix, vectorB, epsilon, maxIterations,
+                                                             verbose, &iterations, &failed);
+            if (!failed) return solution;
+            // несошедшееся решение не возвращаем: либо матрица оказалась не положительно
+            // определенной, либо оценка числа итераций была слишком оптимистичной
+            if (iterations >= maxIterations) {
+                cout << "метод сопряженных градиентов не сошелся за " << maxIterations
+                     << " итераций, переходим к методу гаусса" << endl;
+            } else {
+                cout << "матрица не положительно определена, переходим к методу гаусса" << endl;
+            }
+            return solveGauss(matrix, vectorB, verbose);
+        }
+        case SolverMethod::Gauss:
+            break;
+    }
+    return solveGauss(matrix, vectorB, verbose);
+}
+
+// число систем, которые пакетный метод обрабатывает одновременно (по одной на элемент вектора)
+const int batchLanes = 16;
+
+// метод гаусса с выбором главного элемента для batchLanes систем размера N одновременно;
+// перестановки строк делаются выбором без ветвлений, поэтому все циклы по системам векторизуются;
+// возвращает число вырожденных систем (их решение заполняется NaN)
+template <int N>
+int solveBatchedBlock(double (&a)[N][N][batchLanes], double (&b)[N][batchLanes],
+                      double (&x)[N][batchLanes]) {
+    bool singular[batchLanes] = {};
+
+#pragma GCC unroll 16
+    for (int k = 0; k < N; ++k) {
+        // номер главной строки для каждой системы
+        int pivotRow[batchLanes];
+        double pivotValue[batchLanes];
+        for (int s = 0; s < batchLanes; ++s) {
+            pivotRow[s] = k;
+            pivotValue[s] = fabs(a[k][k][s]);
+        }
+#pragma GCC unroll 16
+        for (int i = k + 1; i < N; ++i) {
+            for (int s = 0; s < batchLanes; ++s) {
+                bool larger = fabs(a[i][k][s]) > pivotValue[s];
+                pivotRow[s] = larger ? i : pivotRow[s];
+                pivotValue[s] = larger ? fabs(a[i][k][s]) : pivotValue[s];
+            }
+        }
+        // перестановка строки k с главной строкой
+#pragma GCC unroll 16
+        for (int i = k + 1; i < N; ++i) {
+#pragma GCC unroll 16
+            for (int j = k; j < N; ++j) {
+                for (int s = 0; s < batchLanes; ++s) {
+                    bool take = pivotRow[s] == i;
+                    double upper = a[k][j][s];
+                    double lower = a[i][j][s];
+                    a[k][j][s] = take ? lower : upper;
+                    a[i][j][s] = take ? upper : lower;
+                }
+            }
+            for (int s = 0; s < batchLanes; ++s) {
+                bool take = pivotRow[s] == i;
+                double upper = b[k][s];
+                double lower = b[i][s];
+                b[k][s] = take ? lower : upper;
+                b[i][s] = take ? upper : lower;
+            }
+        }
+        // исключение переменной k из строк ниже
+        double inverse[batchLanes];
+        for (int s = 0; s < batchLanes; ++s) {
+            singular[s] |= pivotValue[s] < 1e-10;
+            inverse[s] = 1.0 / a[k][k][s];
+        }
+#pragma GCC unroll 16
+        for (int i = k + 1; i < N; ++i) {
+            double factor[batchLanes];
+            for (int s = 0; s < batchLanes; ++s) factor[s] = a[i][k][s] * inverse[s];
+#pragma GCC unroll 16
+            for (int j = k + 1; j < N; ++j) {
+                for (int s = 0; s < batchLanes; ++s) a[i][j][s] -= factor[s] * a[k][j][s];
+            }
+            for (int s = 0; s < batchLanes; ++s) b[i][s] -= factor[s] * b[k][s];
+        }
+    }
+
+    // обратный ход
+#pragma GCC unroll 16
+    for (int k = N - 1; k >= 0; --k) {
+        double sum[batchLanes];
+        for (int s = 0; s < batchLanes; ++s) sum[s] = b[k][s];
+#pragma GCC unroll 16
+        for (int j = k + 1; j < N; ++j) {
+            for (int s = 0; s < batchLanes; ++s) sum[s] -= a[k][j][s] * x[j][s];
+        }
+        for (int s = 0; s < batchLanes; ++s) x[k][s] = sum[s] / a[k][k][s];
+    }
+
+    // решения вырожденных систем помечаем NaN
+    int singularCount = 0;
+    for (int s = 0; s < batchLanes; ++s) {
+        if (!singular[s]) continue;
+        singularCount++;
+        for (int k = 0; k < N; ++k) x[k][s] = NAN;
+    }
+    return singularCount;
+}
+
+// решение count независимых систем размера N в раскладке "структура массивов":
+// элемент (i, j) системы s лежит в matrix[(i * N + j) * count + s],
+// правая часть и решение - в rhs[i * count + s] и solution[i * count + s];
+// возвращает число вырожденных систем
+template <int N>
+size_t solveBatched(const double* matrix, const double* rhs, double* solution,
+                    size_t count, int threadCount = 0) {
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    size_t blocks = (count + batchLanes - 1) / batchLanes;
+    threadCount = int(min<size_t>(threadCount, max<size_t>(blocks, 1)));
+    vector<size_t> singularCounts(threadCount, 0);
+
+    // каждый поток решает свой непрерывный диапазон блоков
+    auto worker = [&](int index) {
+        size_t firstBlock = blocks * index / threadCount;
+        size_t lastBlock = blocks * (index + 1) / threadCount;
+        double a[N][N][batchLanes];
+        double b[N][batchLanes];
+        double x[N][batchLanes];
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            size_t first = block * batchLanes;
+            size_t lanes = min<size_t>(batchLanes, count - first);
+            // копируем блок; недостающие системы заменяем единичными
+            for (int i = 0; i < N; ++i) {
+                for (int j = 0; j < N; ++j) {
+                    const double* source = matrix + size_t(i * N + j) * count + first;
+                    for (size_t s = 0; s < batchLanes; ++s) {
+                        a[i][j][s] = s < lanes ? source[s] : (i == j ? 1.0 : 0.0);
+                    }
+                }
+                for (size_t s = 0; s < batchLanes; ++s) {
+                    b[i][s] = s < lanes ? rhs[size_t(i) * count + first + s] : 0.0;
+                }
+            }
+            int singular = solveBatchedBlock<N>(a, b, x);
+            singularCounts[index] += singular;
+            for (int i = 0; i < N; ++i) {
+                memcpy(solution + size_t(i) * count + first, x[i], lanes * sizeof(double));
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int index = 1; index < threadCount; ++index) threads.emplace_back(worker, index);
+    worker(0);
+    for (auto& t : threads) t.join();
+
+    size_t singularTotal = 0;
+    for (size_t value : singularCounts) singularTotal += value;
+    return singularTotal;
+}
+
+// отображение файла в память только для чтения (без копирования через iostream)
+struct MappedFile {
+    const char* data = nullptr; // начало содержимого файла
+    size_t size = 0;            // размер файла в байтах
+    int descriptor = -1;        // дескриптор открытого файла
+
+    // открываем файл и отображаем его в адресное пространство
+    bool open(const string& filename) {
+        descriptor = ::open(filename.c_str(), O_RDONLY);
+        if (descriptor < 0) return false;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0) {
+            close();
+            return false;
+        }
+        size = info.st_size;
+        // пустой файл отобразить нельзя, но это не ошибка открытия
+        if (size == 0) return true;
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            close();
+            return false;
+        }
+        // файл читается один раз от начала до конца
+        madvise(address, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(address);
+        return true;
+    }
+
+    // снимаем отображение и закрываем файл
+    void close() {
+        if (data) munmap(const_cast<char*>(data), size);
+        if (descriptor >= 0) ::close(descriptor);
+        data = nullptr;
+        size = 0;
+        descriptor = -1;
+    }
+
+    ~MappedFile() { close(); }
+};
+
+// сигнатура двоичного формата: заголовок, затем rows и cols (uint64),
+// затем rows*cols чисел double по строкам в порядке little-endian
+const char binaryMatrixMagic[8] = {'L', 'R', '6', 'D', 'E', 'N', 'S', 'E'};
+const size_t binaryHeaderSize = sizeof(binaryMatrixMagic) + 2 * sizeof(uint64_t);
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "двоичный формат матриц рассчитан на little-endian");
+
+// курсор для разбора текста без iostream
+struct TextCursor {
+    const char* current; // текущая позиция
+    const char* end;     // конец текста
+
+    // пропускаем пробелы и переводы строк
+    void skipSpaces() {
+        while (current < end && (*current == ' ' || *current == '\t' ||
+                                 *current == '\r' || *current == '\n')) {
+            ++current;
+        }
+    }
+
+    // пропускаем остаток текущей строки
+    void skipLine() {
+        const char* newline = static_cast<const char*>(memchr(current, '\n', end - current));
+        current = newline ? newline + 1 : end;
+    }
+
+    // читаем целое число
+    bool readInt(long long& value) {
+        skipSpaces();
+        if (current < end && *current == '+') ++current;
+        auto [next, error] = from_chars(current, end, value);
+        if (error != errc()) return false;
+        current = next;
+        return true;
+    }
+
+    // читаем вещественное число
+    bool readDouble(double& value) {
+        skipSpaces();
+        if (current < end && *current == '+') ++current;
+        auto [next, error] = from_chars(current, end, value);
+        if (error != errc()) return false;
+        current = next;
+        return true;
+    }
+};
+
+// разбор файла матрицы (matrix market или двоичный формат);
+// onSize(rows, cols) вызывается один раз до элементов,
+// onEntry(row, col, value) - для каждого элемента (индексы с нуля)
+template <typename SizeHandler, typename EntryHandler>
+bool parseMatrixFile(const string& filename, SizeHandler onSize, EntryHandler onEntry) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        cerr << "ошибка при открытии файла " << filename << endl;
+        return false;
+    }
+
+    // двоичный формат узнаем по сигнатуре
+    if (file.size >= binaryHeaderSize &&
+        memcmp(file.data, binaryMatrixMagic, sizeof(binaryMatrixMagic)) == 0) {
+        uint64_t rows, cols;
+        memcpy(&rows, file.data + sizeof(binaryMatrixMagic), sizeof(rows));
+        memcpy(&cols, file.data + sizeof(binaryMatrixMagic) + sizeof(rows), sizeof(cols));
+        // произведение rows * cols может переполниться, поэтому делим, а не умножаем
+        uint64_t available = (file.size - binaryHeaderSize) / sizeof(double);
+        if (rows > INT32_MAX || cols > INT32_MAX || (rows != 0 && cols > available / rows)) {
+            cerr << "файл " << filename << " поврежден: неверный размер данных" << endl;
+            return false;
+        }
+        onSize(int(rows), int(cols));
+        const char* values = file.data + binaryHeaderSize;
+        for (uint64_t i = 0; i < rows; ++i) {
+            for (uint64_t j = 0; j < cols; ++j) {
+                double value;
+                memcpy(&value, values + (i * cols + j) * sizeof(double), sizeof(value));
+                onEntry(int(i), int(j), value);
+            }
+        }
+        return true;
+    }
+
+    // иначе ожидаем заголовок matrix market
+    TextCursor cursor{file.data, file.data + file.size};
+    const char header[] = "%%MatrixMarket";
+    if (file.size < sizeof(header) - 1 || memcmp(file.data, header, sizeof(header) - 1) != 0) {
+        cerr << "файл " << filename << " не является матрицей matrix market или двоичной матрицей" << endl;
+        return false;
+    }
+    // определяем формат хранения и симметрию по первой строке
+    const char* headerEnd = static_cast<const char*>(memchr(file.data, '\n', file.size));
+    string banner(file.data, headerEnd ? headerEnd : file.data + file.size);
+    transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+    bool coordinate = banner.find("coordinate") != string::npos;
+    // в кососимметричной матрице a_ji = -a_ij, а диагональ нулевая и не хранится
+    bool skew = banner.find("skew-symmetric") != string::npos;
+    bool symmetric = skew || banner.find("symmetric") != string::npos;
+    double mirrorSign = skew ? -1.0 : 1.0;
+    if (banner.find("complex") != string::npos || banner.find("pattern") != string::npos) {
+        cerr << "поддерживаются только вещественные матрицы matrix market" << endl;
+        return false;
+    }
+
+    // пропускаем заголовок и комментарии
+    cursor.skipLine();
+    cursor.skipSpaces();
+    while (cursor.current < cursor.end && *cursor.current == '%') {
+        cursor.skipLine();
+        cursor.skipSpaces();
+    }
+
+    // читаем размеры
+    long long rows, cols, count = 0;
+    if (!cursor.readInt(rows) || !cursor.readInt(cols) ||
+        (coordinate && !cursor.readInt(count)) ||
+        rows <= 0 || cols <= 0 || rows > INT32_MAX || cols > INT32_MAX) {
+        cerr << "ошибка в строке размеров файла " << filename << endl;
+        return false;
+    }
+    onSize(int(rows), int(cols));
+
+    if (coordinate) {
+        // формат coordinate: тройки "строка столбец значение" с индексами от единицы
+        for (long long k = 0; k < count; ++k) {
+            long long i, j;
+            double value;
+            if (!cursor.readInt(i) || !cursor.readInt(j) || !cursor.readDouble(value) ||
+                i < 1 || i > rows || j < 1 || j > cols) {
+                cerr << "ошибка в элементе " << k + 1 << " файла " << filename << endl;
+                return false;
+            }
+            onEntry(int(i - 1), int(j - 1), value);
+            // в симметричном файле хранится только нижний треугольник
+            if (symmetric && i != j) onEntry(int(j - 1), int(i - 1), mirrorSign * value);
+        }
+    } else {
+        // формат array: значения по столбцам
+        for (long long j = 0; j < cols; ++j) {
+            for (long long i = skew ? j + 1 : symmetric ? j : 0; i < rows; ++i) {
+                double value;
+                if (!cursor.readDouble(value)) {
+                    cerr << "ошибка в элементе (" << i + 1 << ", " << j + 1 << ") файла " << filename << endl;
+                    return false;
+                }
+                onEntry(int(i), int(j), value);
+                if (symmetric && i != j) onEntry(int(j), int(i), mirrorSign * value);
+            }
+        }
+    }
+    return true;
+}
+
+// загрузка квадратной матрицы коэффициентов из файла
+bool loadMatrixFile(const string& filename, vector<vector<double>>& matrix) {
+    bool square = true;
+    bool parsed = parseMatrixFile(filename,
+        [&](int rows, int cols) {
+            square = rows == cols;
+            matrix.assign(square ? rows : 0, vector<double>(square ? cols : 0, 0.0));
+        },
+        [&](int row, int col, double value) {
+            if (square) matrix[row][col] = value;
+        });
+    if (parsed && !square) {
+        cerr << "матрица коэффициентов в файле " << filename << " должна быть квадратной" << endl;
+        return false;
+    }
+    return parsed;
+}
+
+// загрузка вектора правой части из файла (матрица из одного столбца)
+bool loadVectorFile(const string& filename, vector<double>& vec) {
+    bool column = true;
+    bool parsed = parseMatrixFile(filename,
+        [&](int rows, int cols) {
+            column = cols == 1;
+            vec.assign(column ? rows : 0, 0.0);
+        },
+        [&](int row, int, double value) {
+            if (column) vec[row] = value;
+        });
+    if (parsed && !column) {
+        cerr << "вектор правой части в файле " << filename << " должен состоять из одного столбца" << endl;
+        return false;
+    }
+    return parsed;
+}
+
+// лента узкая, если ленточный метод дешевле одного прохода по плотной матрице
+bool isNarrowBand(int size, int lower, int upper) {
+    return 2.0 * (lower + 1) * (lower + upper + 1) < double(size);
+}
+
+// ненулевой элемент разреженной матрицы
+struct MatrixEntry {
+    int row;
+    int col;
+    double value;
+};
+
+// загрузка матрицы коэффициентов: при узкой ленте (или forceBand) - в ленточное хранение
+// (banded = true), иначе - в плотную матрицу. файл coordinate разбирается один раз в список
+// ненулевых элементов (по размеру как сам файл), по которому известна лента. файл array
+// или двоичный содержит все n^2 элементов, поэтому первый проход по отображенному файлу
+// только измеряет ленту, а второй пишет элементы сразу в выбранное хранение: для ленточной
+// системы памяти нужно O(n * b), плотная матрица n x n не создается
+bool loadSystemMatrix(const string& filename, bool forceBand, vector<vector<double>>& dense,
+                      BandMatrix& band, bool& banded) {
+    // формат узнаем по первой строке, не разбирая файл (отображение файла в память дешевое)
+    string banner;
+    {
+        MappedFile file;
+        if (file.open(filename) && file.size) {
+            // в двоичном файле перевода строки может не быть: смотрим только начало файла
+            size_t limit = min<size_t>(file.size, 1024);
+            const char* lineEnd = static_cast<const char*>(memchr(file.data, '\n', limit));
+            banner.assign(file.data, lineEnd ? lineEnd : file.data + limit);
+        }
+    }
+    transform(banner.begin(), banner.end(), banner.begin(), ::tolower);
+    bool coordinate = banner.rfind("%%matrixmarket", 0) == 0 && banner.find("coordinate") != string::npos;
+
+    int size = 0, lower = 0, upper = 0;
+    bool square = true;
+    auto onSize = [&](int rows, int cols) {
+        size = rows;
+        square = rows == cols;
+    };
+    if (coordinate) {
+        vector<MatrixEntry> entries;
+        bool parsed = parseMatrixFile(filename, onSize,
+            [&](int row, int col, double value) {
+                if (value == 0) return;
+                entries.push_back({row, col, value});
+                lower = max(lower, row - col);
+                upper = max(upper, col - row);
+            });
+        if (!parsed) return false;
+        if (!square) {
+            cerr << "матрица коэффициентов в файле " << filename << " должна быть квадратной" << endl;
+            return false;
+        }
+        banded = forceBand || isNarrowBand(size, lower, upper);
+        if (banded) {
+            band.assign(size, lower, upper);
+            for (const MatrixEntry& entry : entries) band.at(entry.row, entry.col) = entry.value;
+        } else {
+            dense.assign(size, vector<double>(size, 0.0));
+            for (const MatrixEntry& entry : entries) dense[entry.row][entry.col] = entry.value;
+        }
+        return true;
+    }
+
+    // первый проход: размер и лента
+    bool parsed = parseMatrixFile(filename, onSize,
+        [&](int row, int col, double value) {
+            if (value == 0) return;
+            lower = max(lower, row - col);
+            upper = max(upper, col - row);
+        });
+    if (!parsed) return false;
+    if (!square) {
+        cerr << "матрица коэффициентов в файле " << filename << " должна быть квадратной" << endl;
+        return false;
+    }
+    banded = forceBand || isNarrowBand(size, lower, upper);
+    // второй проход: элементы сразу в ленту или в плотную матрицу (нули вне ленты пропускаются)
+    if (banded) {
+        band.assign(size, lower, upper);
+        return parseMatrixFile(filename, [](int, int) {},
+            [&](int row, int col, double value) {
+                if (value != 0) band.at(row, col) = value;
+            });
+    }
+    dense.assign(size, vector<double>(size, 0.0));
+    return parseMatrixFile(filename, [](int, int) {},
+        [&](int row, int col, double value) { dense[row][col] = value; });
+}
+
+// сохранение матрицы в двоичном формате
+bool saveBinaryMatrix(const string& filename, const vector<vector<double>>& matrix) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (!file) {
+        cerr << "ошибка при создании файла " << filename << endl;
+        return false;
+    }
+    uint64_t rows = matrix.size();
+    uint64_t cols = rows ? matrix[0].size() : 0;
+    bool ok = fwrite(binaryMatrixMagic, sizeof(binaryMatrixMagic), 1, file) == 1 &&
+              fwrite(&rows, sizeof(rows), 1, file) == 1 &&
+              fwrite(&cols, sizeof(cols), 1, file) == 1;
+    for (const auto& row : matrix) {
+        if (!ok) break;
+        ok = fwrite(row.data(), sizeof(double), cols, file) == cols;
+    }
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) cerr << "ошибка при записи файла " << filename << endl;
+    return ok;
+}
+
+// семейства тестовых матриц для замеров
+enum class TestMatrixKind { DenseDominant, Banded, RandomSparse, Poisson2D, Poisson3D };
+
+// название семейства для отчета
+const char* testMatrixName(TestMatrixKind kind) {
+    switch (kind) {
+        case TestMatrixKind::DenseDominant: return "dense_dominant";
+        case TestMatrixKind::Banded:        return "banded";
+        case TestMatrixKind::RandomSparse:  return "random_sparse";
+        case TestMatrixKind::Poisson2D:     return "poisson_2d";
+        case TestMatrixKind::Poisson3D:     return "poisson_3d";
+    }
+    return "unknown";
+}
+
+// фактический размер системы для семейства (сетки пуассона берутся целыми)
+int testMatrixSize(TestMatrixKind kind, int requested) {
+    if (kind == TestMatrixKind::Poisson2D) {
+        int side = max(2, int(lround(sqrt(double(requested)))));
+        return side * side;
+    }
+    if (kind == TestMatrixKind::Poisson3D) {
+        int side = max(2, int(lround(cbrt(double(requested)))));
+        return side * side * side;
+    }
+    return requested;
+}
+
+// генерация воспроизводимой тестовой системы заданного семейства;
+// правая часть подбирается так, чтобы точным решением был вектор из единиц
+void generateTestSystem(TestMatrixKind kind, int size, uint64_t seed,
+                        vector<vector<double>>& matrix, vector<double>& vectorB) {
+    mt19937_64 generator(seed);
+    uniform_real_distribution<double> offDiagonal(-1.0, 1.0);
+    matrix.assign(size, vector<double>(size, 0.0));
+
+    switch (kind) {
+        case TestMatrixKind::DenseDominant:
+            // все элементы случайные
+            for (int i = 0; i < size; ++i) {
+                for (int j = 0; j < size; ++j) {
+                    if (j != i) matrix[i][j] = offDiagonal(generator);
+                }
+            }
+            break;
+        case TestMatrixKind::Banded: {
+            // случайные элементы в ленте полушириной 5
+            const int halfWidth = 5;
+            for (int i = 0; i < size; ++i) {
+                for (int j = max(0, i - halfWidth); j <= min(size - 1, i + halfWidth); ++j) {
+                    if (j != i) matrix[i][j] = offDiagonal(generator);
+                }
+            }
+            break;
+        }
+        case TestMatrixKind::RandomSparse: {
+            // около пяти ненулевых элементов в строке в случайных столбцах
+            uniform_int_distribution<int> column(0, size - 1);
+            for (int i = 0; i < size; ++i) {
+                for (int k = 0; k < 5; ++k) {
+                    int j = column(generator);
+                    if (j != i) matrix[i][j] = offDiagonal(generator);
+                }
+            }
+            break;
+        }
+        case TestMatrixKind::Poisson2D:
+        case TestMatrixKind::Poisson3D: {
+            // разностный оператор лапласа на равномерной сетке (5 или 7 точек)
+            bool is3D = kind == TestMatrixKind::Poisson3D;
+            int side = is3D ? int(lround(cbrt(double(size)))) : int(lround(sqrt(double(size))));
+            int layer = is3D ? side * side : size;
+            for (int i = 0; i < size; ++i) {
+                int x = i % side;
+                int y = (i / side) % side;
+                int z = i / layer;
+                matrix[i][i] = is3D ? 6.0 : 4.0;
+                if (x > 0) matrix[i][i - 1] = -1.0;
+                if (x < side - 1) matrix[i][i + 1] = -1.0;
+                if (y > 0) matrix[i][i - side] = -1.0;
+                if (y < side - 1) matrix[i][i + side] = -1.0;
+                if (is3D && z > 0) matrix[i][i - layer] = -1.0;
+                if (is3D && z < side - 1) matrix[i][i + layer] = -1.0;
+            }
+            break;
+        }
+    }
+
+    // для случайных семейств обеспечиваем строгое диагональное преобладание
+    if (kind != TestMatrixKind::Poisson2D && kind != TestMatrixKind::Poisson3D) {
+        for (int i = 0; i < size; ++i) {
+            double sum = 0;
+            for (int j = 0; j < size; ++j) sum += fabs(matrix[i][j]);
+            matrix[i][i] = sum + 1.0;
+        }
+    }
+
+    // b = A * (1, 1, ..., 1)
+    vectorB.assign(size, 0.0);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) vectorB[i] += matrix[i][j];
+    }
+}
+
+// результат одного замера
+struct BenchmarkResult {
+    string family;          // семейство матриц
+    string method;          // метод решения
+    int size = 0;           // размер системы
+    bool skipped = false;   // замер не выполнялся (слишком большая задача)
+    double seconds = 0;     // время решения
+    int iterations = 0;     // число итераций (1 для прямого метода)
+    double gflops = 0;      // производительность
+    double bandwidth = 0;   // оценка пропускной способности памяти, ГБ/с
+    double residual = 0;    // максимальная норма невязки
+    double relativeResidual = 0; // ||A x - b||_2 / ||b||_2
+};
+
+// запись результатов в json
+bool saveBenchmarkJson(const string& filename, const vector<BenchmarkResult>& results,
+                       uint64_t seed, double epsilon, int maxIterations) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file) {
+        cerr << "ошибка при создании файла " << filename << endl;
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmark\": \"lr6-3 solvers\",\n  \"seed\": %llu,\n"
+                  "  \"epsilon\": %g,\n  \"max_iterations\": %d,\n  \"results\": [\n",
+            (unsigned long long)seed, epsilon, maxIterations);
+    for (size_t k = 0; k < results.size(); ++k) {
+        const BenchmarkResult& r = results[k];
+        fprintf(file, "    {\"family\": \"%s\", \"method\": \"%s\", \"n\": %d, ",
+                r.family.c_str(), r.method.c_str(), r.size);
+        if (r.skipped) {
+            fprintf(file, "\"skipped\": true}");
+        } else {
+            fprintf(file, "\"seconds\": %.9g, \"iterations\": %d, \"gflops\": %.6g, "
+                          "\"bandwidth_gbs\": %.6g, \"residual\": %.6g, \"relative_residual\": %.6g}",
+                    r.seconds, r.iterations, r.gflops, r.bandwidth, r.residual, r.relativeResidual);
+        }
+        fprintf(file, "%s\n", k + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = fclose(file) == 0;
+    if (!ok) cerr << "ошибка при записи файла " << filename << endl;
+    return ok;
+}
+
+// замеры методов на семействах матриц разных размеров
+int runBenchmark(int argc, char* argv[]) {
+    // наибольший размер системы и файл отчета
+    int maxSize = argc > 2 ? atoi(argv[2]) : 1000;
+    string outputFile = argc > 3 ? argv[3] : "lr6-3-bench.json";
+    const uint64_t seed = 20240601;
+    const double epsilon = 1e-6;
+    const int maxIterations = 1000;
+    // ограничения для плотного хранения: память под матрицу и кубическая сложность гаусса
+    const double denseMemoryLimit = 2e9;
+    const int gaussSizeLimit = 2000;
+
+    const TestMatrixKind kinds[] = {
+        TestMatrixKind::DenseDominant, TestMatrixKind::Banded, TestMatrixKind::RandomSparse,
+        TestMatrixKind::Poisson2D, TestMatrixKind::Poisson3D
+    };
+    const char* methods[] = {"gauss", "jacobi", "seidel"};
+
+    vector<BenchmarkResult> results;
+    vector<double> residual; // память под невязку, общая для всех замеров
+    cout << left << setw(16) << "семейство" << setw(8) << "метод" << right << setw(9) << "n"
+         << setw(12) << "время, с" << setw(8) << "итер." << setw(10) << "GFLOP/s"
+         << setw(10) << "ГБ/с" << setw(13) << "невязка" << endl;
+
+    for (TestMatrixKind kind : kinds) {
+        for (int requested = 10; requested <= maxSize && requested <= 1000000; requested *= 10) {
+            int size = testMatrixSize(kind, requested);
+            double n = size;
+            bool fits = n * n * sizeof(double) <= denseMemoryLimit;
+
+            vector<vector<double>> matrixA;
+            vector<double> vectorB;
+            if (fits) generateTestSystem(kind, size, seed + size, matrixA, vectorB);
+
+            for (const char* method : methods) {
+                BenchmarkResult result;
+                result.family = testMatrixName(kind);
+                result.method = method;
+                result.size = size;
+                result.skipped = !fits || (string(method) == "gauss" && size > gaussSizeLimit);
+                if (!result.skipped) {
+                    vector<double> solution;
+                    auto start = chrono::steady_clock::now();
+                    if (string(method) == "gauss") {
+                        solution = solveGauss(matrixA, vectorB, false);
+                        result.iterations = 1;
+                    } else if (string(method) == "jacobi") {
+                        solution = solveJacobi(matrixA, vectorB, epsilon, maxIterations, false, &result.iterations);
+                    } else {
+                        solution = solveSeidel(matrixA, vectorB, epsilon, maxIterations, false, &result.iterations);
+                    }
+                    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+                    // операции и трафик: исключение ~2n^3/3, итерация ~2n^2 с чтением всей матрицы
+                    double flops, bytes;
+                    if (string(method) == "gauss") {
+                        flops = 2.0 * n * n * n / 3.0;
+                        bytes = 2.0 * sizeof(double) * n * n * n / 3.0;
+                    } else {
+                        flops = 2.0 * n * n * result.iterations;
+                        bytes = sizeof(double) * n * n * result.iterations;
+                    }
+                    double seconds = max(result.seconds, 1e-9);
+                    result.gflops = flops / seconds * 1e-9;
+                    result.bandwidth = bytes / seconds * 1e-9;
+                    ResidualNorms norms = computeResidual(matrixA, vectorB, solution, residual);
+                    result.residual = norms.maximum;
+                    result.relativeResidual = norms.relative;
+                }
+
+                // строка таблицы
+                cout << left << setw(16) << result.family << setw(8) << result.method
+                     << right << setw(9) << result.size;
+                if (result.skipped) {
+                    cout << setw(12) << "-" << "  пропущено" << endl;
+                } else {
+                    cout << fixed << setprecision(6) << setw(12) << result.seconds
+                         << setw(8) << result.iterations << setprecision(3)
+                         << setw(10) << result.gflops << setw(10) << result.bandwidth
+                         << scientific << setprecision(2) << setw(13) << result.residual << endl;
+                    cout.unsetf(ios::floatfield);
+                }
+                results.push_back(result);
+            }
+        }
+    }
+
+    if (!saveBenchmarkJson(outputFile, results, seed, epsilon, maxIterations)) return 1;
+    cout << "результаты сохранены в файл: " << outputFile << endl;
+    return 0;
+}
+
+// вывод подсказки по запуску из командной строки
+void printUsage(const char* program) {
+    cout << "использование:\n"
+         << "  " << program << "                                    - пример из задания\n"
+         << "  " << program << " <матрица> <правая часть> [метод] [точность] [итерации]\n"
+         << "      метод: auto, gauss, band, jacobi, seidel, cg или all (по умолчанию auto)\n"
+         << "  " << program << " --convert <файл.mtx> <файл.bin>  - перевод в двоичный формат\n"
+         << "  " << program << " --bench [макс. размер] [отчет.json] - замеры методов\n"
+         << "  " << program << " --batch [число систем] [потоки]  - пакетное решение систем 4x4\n"
+         << "  " << program << " --timesteps [размер] [шаги]     - теплый старт на шагах по времени\n"
+         << "  " << program << " --solution <матрица> <правая часть> <метод> [точность] [итерации]\n"
+         << "      - только решение (gauss, jacobi или seidel) с 17 значащими цифрами\n"
+         << "файлы: matrix market (.mtx) или двоичный формат LR6DENSE\n";
+}
+
+// пакетное решение множества систем 4x4, похожих на систему из задания
+int runBatchedDemo(int argc, char* argv[]) {
+    const int N = 4;
+    size_t count = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    int threadCount = argc > 3 ? atoi(argv[3]) : 0;
+    if (count == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // система из задания
+    double M = 1.09, Nc = -0.16, P = 0.84;
+    const double baseA[N][N] = {
+        {M, -0.04, 0.21, -18},
+        {0.25, -1.23, Nc, -0.09},
+        {-0.21, Nc, 0.8, -0.13},
+        {0.15, -1.31, 0.06, P}
+    };
+    const double baseB[N] = {-1.24, P, 2.56, M};
+
+    // системы со случайными возмущениями коэффициентов (система 0 - без возмущений)
+    vector<double> matrix(size_t(N) * N * count);
+    vector<double> rhs(size_t(N) * count);
+    vector<double> solution(size_t(N) * count);
+    mt19937_64 generator(20240601);
+    uniform_real_distribution<double> noise(-0.05, 0.05);
+    for (size_t s = 0; s < count; ++s) {
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) {
+                matrix[size_t(i * N + j) * count + s] = baseA[i][j] + (s ? noise(generator) : 0.0);
+            }
+            rhs[size_t(i) * count + s] = baseB[i] + (s ? noise(generator) : 0.0);
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t singular = solveBatched<N>(matrix.data(), rhs.data(), solution.data(), count, threadCount);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    // сверяем несколько систем с обычным методом гаусса
+    double maxDifference = 0;
+    for (size_t s = 0; s < count; s += max<size_t>(1, count / 16)) {
+        vector<vector<double>> systemA(N, vector<double>(N));
+        vector<double> systemB(N);
+        for (int i = 0; i < N; ++i) {
+            for (int j = 0; j < N; ++j) systemA[i][j] = matrix[size_t(i * N + j) * count + s];
+            systemB[i] = rhs[size_t(i) * count + s];
+        }
+        vector<double> expected = solveGauss(systemA, systemB, false);
+        for (int i = 0; i < N; ++i) {
+            maxDifference = max(maxDifference, fabs(expected[i] - solution[size_t(i) * count + s]));
+        }
+    }
+
+    cout << "решено систем 4x4: " << count << " за " << seconds << " с ("
+         << count / max(seconds, 1e-9) / 1e6 << " млн систем/с)" << endl;
+    cout << "вырожденных систем: " << singular << endl;
+    cout << "решение системы из задания:";
+    for (int i = 0; i < N; ++i) cout << " " << solution[size_t(i) * count];
+    cout << "\nрасхождение с методом гаусса: " << maxDifference << endl;
+    return 0;
+}
+
+// шаги по времени с медленно меняющейся системой: сравнение холодного и теплого старта
+int runTimeStepping(int argc, char* argv[]) {
+    int size = argc > 2 ? atoi(argv[2]) : 400;
+    int steps = argc > 3 ? atoi(argv[3]) : 10;
+    if (size < 2 || steps < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const double epsilon = 1e-8;
+    const int maxIterations = 1000;
+
+    // начальная система - разностный оператор пуассона, на котором итерации сходятся медленно
+    size = testMatrixSize(TestMatrixKind::Poisson2D, size);
+    vector<vector<double>> matrixA;
+    vector<double> vectorB;
+    generateTestSystem(TestMatrixKind::Poisson2D, size, 20240601, matrixA, vectorB);
+    IterativeSolverState state;
+    if (!initSolverState(matrixA, state)) return 1;
+
+    mt19937_64 generator(7);
+    uniform_int_distribution<int> index(0, size - 1);
+    uniform_real_distribution<double> drift(-1e-5, 1e-5);
+
+    cout << "шаг\tхолодный старт\tтеплый старт\tразница решений" << endl;
+    for (int step = 0; step < steps; ++step) {
+        if (step > 0) {
+            // немного меняем несколько ненулевых элементов и правую часть
+            for (int k = 0; k < 8; ++k) {
+                int row = index(generator);
+                int col = k % 2 ? row : max(0, row - 1);
+                if (!updateMatrixEntry(matrixA, state, row, col,
+                                       matrixA[row][col] * (1.0 + drift(generator)))) {
+                    return 1;
+                }
+            }
+            for (double& value : vectorB) value *= 1.0 + drift(generator);
+        }
+
+        // холодный старт с нулевого приближения
+        int coldIterations = 0;
+        vector<double> cold = solveSeidel(matrixA, vectorB, epsilon, maxIterations, false, &coldIterations);
+        // теплый старт с решения предыдущего шага
+        int warmIterations = 0;
+        solveSeidel(matrixA, vectorB, epsilon, maxIterations, false, &warmIterations, nullptr, nullptr, &state);
+
+        double difference = 0;
+        for (int i = 0; i < size; ++i) difference = max(difference, fabs(cold[i] - state.solution[i]));
+        cout << step << "\t" << coldIterations << "\t\t" << warmIterations << "\t\t" << difference << endl;
+    }
+    return 0;
+}
+
+// решение загруженной ленточной системы с правой частью из файла
+int solveBandFromFiles(const BandMatrix& band, const string& vectorFile) {
+    vector<double> vectorB;
+    if (!loadVectorFile(vectorFile, vectorB)) return 1;
+    if (band.size != int(vectorB.size())) {
+        cerr << "размер матрицы (" << band.size << ") не совпадает с размером правой части ("
+             << vectorB.size() << ")" << endl;
+        return 1;
+    }
+    cout << "загружена ленточная система размером " << band.size << " (" << band.lower
+         << " ниже и " << band.upper << " выше диагонали)" << endl;
+
+    // прогонка для устойчивых трехдиагональных систем, иначе ленточный гаусс
+    bool tridiagonal = isStableTridiagonal(band);
+    auto start = chrono::steady_clock::now();
+    vector<double> solution = solveBandSystem(band, vectorB);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "\nрешение " << (tridiagonal ? "методом прогонки" : "ленточным методом гаусса")
+         << " за " << seconds << " с:\n";
+    if (solution.size() <= 20) printVector(solution);
+    cout << "норма невязки: " << scientific << maxNorm(calculateBandResidual(band, vectorB, solution)) << endl;
+    cout.unsetf(ios::floatfield);
+    return 0;
+}
+
+// решение системы, загруженной из файлов
+int solveFromFiles(int argc, char* argv[]) {
+    // перевод текстового файла в двоичный
+    if (string(argv[1]) == "--convert") {
+        if (argc != 4) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        vector<vector<double>> matrix;
+        if (!parseMatrixFile(argv[2],
+                [&](int rows, int cols) { matrix.assign(rows, vector<double>(cols, 0.0)); },
+                [&](int row, int col, double value) { matrix[row][col] = value; })) {
+            return 1;
+        }
+        return saveBinaryMatrix(argv[3], matrix) ? 0 : 1;
+    }
+
+    if (argc < 3 || argc > 6) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    string method = argc > 3 ? argv[3] : "auto";
+    double epsilon = argc > 4 ? atof(argv[4]) : 1e-3;
+    int maxIterations = argc > 5 ? atoi(argv[5]) : 100;
+    if (method != "auto" && method != "gauss" && method != "band" && method != "jacobi" &&
+        method != "seidel" && method != "cg" && method != "all") {
+        cerr << "неизвестный метод: " << method << endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // загружаем систему; ленточные системы решаем без построения плотной матрицы
+    vector<vector<double>> matrixA;
+    vector<double> vectorB;
+    if (method == "auto" || method == "band") {
+        BandMatrix band;
+        bool banded = false;
+        if (!loadSystemMatrix(argv[1], method == "band", matrixA, band, banded)) return 1;
+        if (banded) return solveBandFromFiles(band, argv[2]);
+    } else if (!loadMatrixFile(argv[1], matrixA)) {
+        return 1;
+    }
+    if (!loadVectorFile(argv[2], vectorB)) return 1;
+    if (matrixA.size() != vectorB.size()) {
+        cerr << "размер матрицы (" << matrixA.size() << ") не совпадает с размером правой части ("
+             << vectorB.size() << ")" << endl;
+        return 1;
+    }
+    cout << "загружена система размером " << matrixA.size() << endl;
+
+    // подробный вывод шагов имеет смысл только для маленьких систем
+    bool verbose = matrixA.size() <= 10;
+
+    // решаем выбранным методом и выводим решение с нормами невязки;
+    // для итерационных методов history - нормы невязки по итерациям
+    vector<double> residual;
+    auto report = [&](const string& title, const vector<double>& solution,
+                      const vector<ResidualNorms>& history = {}) {
+        cout << "\nрешение методом " << title << ":\n";
+        if (solution.size() <= 20) printVector(solution);
+        ResidualNorms norms = computeResidual(matrixA, vectorB, solution, residual);
+        cout << "норма невязки: " << scientific << norms.maximum << " (евклидова " << norms.l2
+             << ", относительная " << norms.relative << ")" << endl;
+        if (history.size() > 1) {
+            // средний коэффициент уменьшения невязки за итерацию
+            double factor = pow(history.back().l2 / max(history.front().l2, 1e-300), 1.0 / (history.size() - 1));
+            cout << "невязка по итерациям: " << history.front().l2 << " -> " << history.back().l2
+                 << " за " << history.size() << " итераций, множитель за итерацию " << fixed << setprecision(4)
+                 << factor << endl;
+        }
+        cout.unsetf(ios::floatfield);
+        cout << setprecision(6);
+    };
+    vector<ResidualNorms> history;
+    if (method == "auto") {
+        report("по выбору анализатора", solveAutomatic(matrixA, vectorB, epsilon, maxIterations, verbose));
+    }
+    if (method == "gauss" || method == "all") {
+        report("гаусса", solveGauss(matrixA, vectorB, verbose));
+    }
+    if (method == "jacobi" || method == "all") {
+        history.clear();
+        vector<double> solution = solveJacobi(matrixA, vectorB, epsilon, maxIterations, verbose, nullptr, &history);
+        report("якоби", solution, history);
+    }
+    if (method == "seidel" || method == "all") {
+        history.clear();
+        vector<double> solution = solveSeidel(matrixA, vectorB, epsilon, maxIterations, verbose, nullptr, &history);
+        report("гаусса-зейделя", solution, history);
+    }
+    if (method == "cg" || method == "all") {
+        report("сопряженных градиентов",
+               solveConjugateGradient(matrixA, vectorB, epsilon, maxIterations, verbose));
+    }
+    return 0;
+}
+
+// решение системы из файлов с выводом только решения (для сверки с другими реализациями):
+// первая строка - время решения, затем компоненты решения по одной в строке с 17 значащими цифрами
+// lr6-3 --solution <матрица> <правая часть> <gauss|jacobi|seidel> [точность] [итерации]
+int runSolutionOutput(int argc, char* argv[]) {
+    if (argc < 5) {
+        cerr << "использование: " << argv[0]
+             << " --solution <матрица> <правая часть> <gauss|jacobi|seidel> [точность] [итерации]" << endl;
+        return 1;
+    }
+    string method = argv[4];
+    double epsilon = argc > 5 ? atof(argv[5]) : 1e-3;
+    int maxIterations = argc > 6 ? atoi(argv[6]) : 100;
+    if (method != "gauss" && method != "jacobi" && method != "seidel") {
+        cerr << "неизвестный метод: " << method << endl;
+        return 1;
+    }
+    vector<vector<double>> matrixA;
+    vector<double> vectorB;
+    if (!loadMatrixFile(argv[2], matrixA) || !loadVectorFile(argv[3], vectorB)) return 1;
+    if (matrixA.size() != vectorB.size()) {
+        cerr << "размер матрицы (" << matrixA.size() << ") не совпадает с размером правой части ("
+             << vectorB.size() << ")" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<double> solution = method == "gauss"  ? solveGauss(matrixA, vectorB, false)
+                              : method == "jacobi" ? solveJacobi(matrixA, vectorB, epsilon, maxIterations, false)
+                                                   : solveSeidel(matrixA, vectorB, epsilon, maxIterations, false);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "решено за " << seconds << " с" << endl;
+    OutputBuffer out(cout);
+    for (double value : solution) {
+        out.writeDouble(value, chars_format::general, 17);
+        out.put('\n');
+    }
+    return 0;
+}
+
 // главная функция программы
-int main() {
+// без main, когда файл подключается в общий стенд замеров lr6-bench.cpp
+#ifndef LR6_NO_MAIN
+int main(int argc, char* argv[]) {
+    // если заданы файлы, решаем систему из них
+    if (argc > 1) {
+        if (string(argv[1]) == "--bench") return runBenchmark(argc, argv);
+        if (string(argv[1]) == "--batch") return runBatchedDemo(argc, argv);
+        if (string(argv[1]) == "--timesteps") return runTimeStepping(argc, argv);
+        if (string(argv[1]) == "--solution") return runSolutionOutput(argc, argv);
+        return solveFromFiles(argc, argv);
+    }
+
+
     // задаем параметры системы
     double M = 1.09;
     double N = -0.16;
@@ -432,4 +2306,5 @@ int main() {
 
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -122,14 +122,16 @@ fn calculate_residual(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, solution: &Ve
 }
 
 // метод гаусса с выбором главного элемента
-fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
+fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>, verbose: bool) -> Vec<f64> {
     // получаем размер системы
     let size = matrix.len();
     // создаем вектор для хранения решения
     let mut solution = vec![0.0; size];
     
     // выводим заголовок для прямого хода
-    println!("\nпрямой ход метода гаусса:");
+    if verbose {
+        println!("\nпрямой ход метода гаусса:");
+    }
     
     // прямой ход метода (приведение к треугольному виду)
     for k in 0..size {
@@ -155,7 +157,9 @@ fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
             // меняем соответствующие элементы в векторе правой части
             vector_b.swap(k, max_row);
             // выводим сообщение о перестановке
-            println!("перестановка строк {} и {}", k+1, max_row+1);
+            if verbose {
+                println!("перестановка строк {} и {}", k+1, max_row+1);
+            }
         }
         
         // проверка на вырожденность матрицы
@@ -176,10 +180,12 @@ fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
         vector_b[k] /= divisor;
         
         // выводим матрицу после нормировки
-        println!("после нормировки строки {}:", k+1);
-        print_matrix(&matrix);
-        println!("вектор b: ");
-        print_vector(&vector_b);
+        if verbose {
+            println!("после нормировки строки {}:", k+1);
+            print_matrix(&matrix);
+            println!("вектор b: ");
+            print_vector(&vector_b);
+        }
         
         // исключаем текущую переменную из всех нижних строк
         for i in k+1..size {
@@ -194,14 +200,18 @@ fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
         }
         
         // выводим матрицу после исключения
-        println!("после исключения в столбце {}:", k+1);
-        print_matrix(&matrix);
-        println!("вектор b: ");
-        print_vector(&vector_b);
+        if verbose {
+            println!("после исключения в столбце {}:", k+1);
+            print_matrix(&matrix);
+            println!("вектор b: ");
+            print_vector(&vector_b);
+        }
     }
     
     // выводим заголовок для обратного хода
-    println!("\nобратный ход метода гаусса:");
+    if verbose {
+        println!("\nобратный ход метода гаусса:");
+    }
     
     // обратный ход (нахождение решения)
     for k in (0..size).rev() {
@@ -212,7 +222,9 @@ fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
             solution[k] -= matrix[k][j] * solution[j];
         }
         // выводим найденное значение переменной
-        println!("x[{}] = {}", k+1, solution[k]);
+        if verbose {
+            println!("x[{}] = {}", k+1, solution[k]);
+        }
     }
     
     // возвращаем полученное решение
@@ -220,7 +232,7 @@ fn solve_gauss(mut matrix: Vec<Vec<f64>>, mut vector_b: Vec<f64>) -> Vec<f64> {
 }
 
 // метод якоби для решения системы
-fn solve_jacobi(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_iterations: usize) -> Vec<f64> {
+fn solve_jacobi(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_iterations: usize, verbose: bool) -> Vec<f64> {
     // получаем размер системы
     let size = matrix.len();
     // создаем вектор для решения (начальное приближение - нули)
@@ -233,8 +245,10 @@ fn solve_jacobi(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
     let mut error;
     
     // выводим заголовок для итерационного процесса
-    println!("\nметод якоби (начальное приближение - нулевое):");
-    println!("n\tx1\t\tx2\t\tx3\t\tx4\t\tεn");
+    if verbose {
+        println!("\nметод якоби (начальное приближение - нулевое):");
+        println!("n\tx1\t\tx2\t\tx3\t\tx4\t\tεn");
+    }
     
     // основной итерационный цикл
     loop {
@@ -258,14 +272,16 @@ fn solve_jacobi(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
             error = f64::max(error, f64::abs(new_solution[i] - solution[i]));
         }
         
-        // выводим номер текущей итерации
-        print!("{}\t", iterations);
-        // выводим значения переменных с точностью 6 знаков после запятой
-        for i in 0..size {
-            print!("{:.6}\t", new_solution[i]);
+        if verbose {
+            // выводим номер текущей итерации
+            print!("{}\t", iterations);
+            // выводим значения переменных с точностью 6 знаков после запятой
+            for i in 0..size {
+                print!("{:.6}\t", new_solution[i]);
+            }
+            // выводим текущую погрешность
+            println!("{:.6}", error);
         }
-        // выводим текущую погрешность
-        println!("{:.6}", error);
         
         // обновляем решение
         solution.copy_from_slice(&new_solution);
@@ -289,7 +305,7 @@ fn solve_jacobi(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
 }
 
 // метод гаусса-зейделя для решения системы
-fn solve_seidel(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_iterations: usize) -> Vec<f64> {
+fn solve_seidel(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_iterations: usize, verbose: bool) -> Vec<f64> {
     // получаем размер системы
     let size = matrix.len();
     // создаем вектор для решения (начальное приближение - нули)
@@ -300,8 +316,10 @@ fn solve_seidel(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
     let mut error;
     
     // выводим заголовок для итерационного процесса
-    println!("\nметод гаусса-зейделя (начальное приближение - нулевое):");
-    println!("n\tx1\t\tx2\t\tx3\t\tx4\t\tεn");
+    if verbose {
+        println!("\nметод гаусса-зейделя (начальное приближение - нулевое):");
+        println!("n\tx1\t\tx2\t\tx3\t\tx4\t\tεn");
+    }
     
     // основной итерационный цикл
     loop {
@@ -328,14 +346,16 @@ fn solve_seidel(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
             solution[i] = new_value;
         }
         
-        // выводим номер текущей итерации
-        print!("{}\t", iterations);
-        // выводим значения переменных с точностью 6 знаков после запятой
-        for i in 0..size {
-            print!("{:.6}\t", solution[i]);
+        if verbose {
+            // выводим номер текущей итерации
+            print!("{}\t", iterations);
+            // выводим значения переменных с точностью 6 знаков после запятой
+            for i in 0..size {
+                print!("{:.6}\t", solution[i]);
+            }
+            // выводим текущую погрешность
+            println!("{:.6}", error);
         }
-        // выводим текущую погрешность
-        println!("{:.6}", error);
         
         // увеличиваем счетчик итераций
         iterations += 1;
@@ -355,7 +375,122 @@ fn solve_seidel(matrix: &Vec<Vec<f64>>, vector_b: &Vec<f64>, epsilon: f64, max_i
     solution
 }
 
+// чтение плотной матрицы из файла matrix market (форматы array и coordinate, вещественные)
+fn load_matrix_market(filename: &str) -> Result<Vec<Vec<f64>>, String> {
+    let text = std::fs::read_to_string(filename)
+        .map_err(|e| format!("ошибка при открытии файла {}: {}", filename, e))?;
+    let mut lines = text.lines();
+    let banner = lines.next().unwrap_or("").to_lowercase();
+    if !banner.starts_with("%%matrixmarket") {
+        return Err(format!("файл {} не является матрицей matrix market", filename));
+    }
+    if banner.contains("complex") || banner.contains("pattern") {
+        return Err("поддерживаются только вещественные матрицы matrix market".to_string());
+    }
+    let coordinate = banner.contains("coordinate");
+    let symmetric = banner.contains("symmetric");
+
+    // все числа после комментариев одним потоком
+    let mut tokens = lines
+        .filter(|line| !line.trim_start().starts_with('%'))
+        .flat_map(|line| line.split_whitespace());
+    let mut next_number = |what: &str| -> Result<f64, String> {
+        tokens
+            .next()
+            .and_then(|token| token.parse::<f64>().ok())
+            .ok_or_else(|| format!("ошибка в файле {}: ожидалось {}", filename, what))
+    };
+
+    let rows = next_number("число строк")? as usize;
+    let cols = next_number("число столбцов")? as usize;
+    let mut matrix = vec![vec![0.0; cols]; rows];
+    if coordinate {
+        // тройки "строка столбец значение" с индексами от единицы
+        let count = next_number("число элементов")? as usize;
+        for _ in 0..count {
+            let i = next_number("номер строки")? as usize;
+            let j = next_number("номер столбца")? as usize;
+            let value = next_number("значение")?;
+            if i < 1 || i > rows || j < 1 || j > cols {
+                return Err(format!("ошибка в файле {}: индекс вне матрицы", filename));
+            }
+            matrix[i - 1][j - 1] = value;
+            if symmetric && i != j {
+                matrix[j - 1][i - 1] = value;
+            }
+        }
+    } else {
+        // формат array: значения по столбцам (для симметричных - нижний треугольник)
+        for j in 0..cols {
+            let first_row = if symmetric { j } else { 0 };
+            for i in first_row..rows {
+                let value = next_number("значение")?;
+                matrix[i][j] = value;
+                if symmetric {
+                    matrix[j][i] = value;
+                }
+            }
+        }
+    }
+    Ok(matrix)
+}
+
+// решение системы из файлов с выводом только решения (для сверки с реализацией на c++):
+// первая строка - время решения, затем компоненты решения по одной в строке
+// lr6-3r --solution <матрица> <правая часть> <gauss|jacobi|seidel> [точность] [итерации]
+fn run_solution_output(args: &[String]) -> i32 {
+    if args.len() < 5 {
+        eprintln!("использование: {} --solution <матрица> <правая часть> <gauss|jacobi|seidel> [точность] [итерации]", args[0]);
+        return 1;
+    }
+    let method = args[4].as_str();
+    let epsilon: f64 = args.get(5).and_then(|v| v.parse().ok()).unwrap_or(1e-3);
+    let max_iterations: usize = args.get(6).and_then(|v| v.parse().ok()).unwrap_or(100);
+    if method != "gauss" && method != "jacobi" && method != "seidel" {
+        eprintln!("неизвестный метод: {}", method);
+        return 1;
+    }
+    let (matrix_a, column_b) = match (load_matrix_market(&args[2]), load_matrix_market(&args[3])) {
+        (Ok(a), Ok(b)) => (a, b),
+        (Err(e), _) | (_, Err(e)) => {
+            eprintln!("{}", e);
+            return 1;
+        }
+    };
+    if column_b.iter().any(|row| row.len() != 1) {
+        eprintln!("вектор правой части в файле {} должен состоять из одного столбца", args[3]);
+        return 1;
+    }
+    let vector_b: Vec<f64> = column_b.iter().map(|row| row[0]).collect();
+    if matrix_a.len() != vector_b.len() {
+        eprintln!("размер матрицы ({}) не совпадает с размером правой части ({})", matrix_a.len(), vector_b.len());
+        return 1;
+    }
+
+    let start = std::time::Instant::now();
+    let solution = match method {
+        "gauss" => solve_gauss(matrix_a, vector_b, false),
+        "jacobi" => solve_jacobi(&matrix_a, &vector_b, epsilon, max_iterations, false),
+        _ => solve_seidel(&matrix_a, &vector_b, epsilon, max_iterations, false),
+    };
+    let seconds = start.elapsed().as_secs_f64();
+
+    // вывод одной строкой-буфером: println! на каждое число слишком медленный
+    let mut output = format!("решено за {} с\n", seconds);
+    for value in &solution {
+        output.push_str(&format!("{:e}\n", value));
+    }
+    print!("{}", output);
+    0
+}
+
 fn main() {
+    // режим сверки: решение системы из файлов
+    let args: Vec<String> = std::env::args().collect();
+    if args.len() > 1 && args[1] == "--solution" {
+        std::process::exit(run_solution_output(&args));
+    }
+
     // задаем параметры системы
     let m = 1.09;
     let n = -0.16;
@@ -396,7 +531,7 @@ fn main() {
 
     // решаем систему методом гаусса
     println!("\n=== решение методом гаусса ===");
-    let solution_gauss = solve_gauss(matrix_a.clone(), vector_b.clone());
+    let solution_gauss = solve_gauss(matrix_a.clone(), vector_b.clone(), true);
     println!("\nрешение методом гаусса:");
     print_vector(&solution_gauss);
     println!("невязка:");
@@ -404,7 +539,7 @@ fn main() {
 
     // решаем систему методом якоби
     println!("\n=== решение методом якоби с точностью 0.001 ===");
-    let solution_jacobi = solve_jacobi(&matrix_a, &vector_b, 1e-3, 100);
+    let solution_jacobi = solve_jacobi(&matrix_a, &vector_b, 1e-3, 100, true);
     println!("\nрешение методом якоби:");
     print_vector(&solution_jacobi);
     println!("невязка:");
@@ -412,7 +547,7 @@ fn main() {
 
     // решаем систему методом гаусса-зейделя
     println!("\n=== решение методом гаусса-зейделя с точностью 0.001 ===");
-    let solution_seidel = solve_seidel(&matrix_a, &vector_b, 1e-3, 100);
+    let solution_seidel = solve_seidel(&matrix_a, &vector_b, 1e-3, 100, true);
     println!("\nрешение методом гаусса-зейделя:");
     print_vector(&solution_seidel);
     println!("невязка:");
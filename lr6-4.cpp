@@ -1,33 +1,47 @@
 #include <iostream>
-#include <cstdint> 
-#include <algorithm> 
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "lr6-output.h"
+#include "lr6-profile.h"
 using namespace std;
 
+// площадь дорожки ширины w вокруг поля n x m: n*m - (n-2w)(m-2w) = 2w(n+m-2w)
+inline int64_t roadArea(int64_t n, int64_t m, int64_t w) {
+    return 2 * w * (n + m - 2 * w);
+}
 
-int main() {
-    int64_t n, m, t; // объявление переменных для размеров площади и количества плиток
-
-    // чтение входных данных
-    cin >> n >> m >> t;
-
+// проверка входных данных; возвращает текст ошибки или nullptr, если запрос корректен
+const char* validateQuery(int64_t n, int64_t m, int64_t t) {
     // проверка, чтобы размеры были не меньше 3
-    if (n < 3 || m < 3) {
-        cout << "Ошибка: размеры площади должны быть ≥ 3." << endl;
-        return 1; // завершение программы с кодом ошибки
-    }
-
+    if (n < 3 || m < 3) return "Ошибка: размеры площади должны быть ≥ 3.";
     // проверка, чтобы количество плиток было не меньше 1
-    if (t < 1) {
-        cout << "Ошибка: количество плиток должно быть ≥ 1." << endl;
-        return 1; // завершение программы с кодом ошибки
-    }
-
-    // проверка, чтобы плиток не было слишком много (не покрывали бы всю площадь)
-    if (t >= n * m) {
-        cout << "Ошибка: плиток слишком много, они покрывают всю площадь." << endl;
-        return 1; // завершение программы с кодом ошибки
-    }
+    if (t < 1) return "Ошибка: количество плиток должно быть ≥ 1.";
+    // проверка, чтобы плиток не было слишком много (не покрывали бы всю площадь);
+    // если n*m не помещается в int64, то площадь заведомо больше любого t
+    int64_t area;
+    if (!__builtin_mul_overflow(n, m, &area) && t >= area)
+        return "Ошибка: плиток слишком много, они покрывают всю площадь.";
+    return nullptr;
+}
 
+// исходное решение бинарным поиском по ширине (оставлено для сверки)
+int64_t maxPathWidthBinarySearch(int64_t n, int64_t m, int64_t t) {
     // установка границ бинарного поиска для ширины дорожки
     int64_t left = 0; // левая граница (минимальная ширина)
     int64_t right = min(n, m) / 2; // правая граница (максимальная возможная ширина)
@@ -60,9 +74,539 @@ int main() {
             right = mid - 1; // ищем в левой части
         }
     }
+    return maxWidth;
+}
+
+// наибольшая сторона, при которой n*m и все площади дорожек заведомо помещаются в int64:
+// floor(sqrt(2^63 - 1))
+const int64_t safeSide = 3037000499;
+
+// площадь дорожки в 128-битной арифметике (для сторон больше safeSide)
+inline __int128 roadAreaWide(int64_t n, int64_t m, int64_t w) {
+    return __int128(2) * w * (__int128(n) + m - __int128(2) * w);
+}
+
+// решение за O(1): 2w(s-2w) <= t при s = n+m равносильно w <= t / (s + sqrt(D)),
+// где D = s^2 - 4t = (n-m)^2 + 4(nm - t) - меньший корень в записи без вычитания близких чисел;
+// оценка точна до единицы и уточняется точной целочисленной проверкой соседних ширин без ветвлений.
+// подходит, пока n*m помещается в int64 (сам n*m - t считается точно)
+inline int64_t maxPathWidthSafe(int64_t n, int64_t m, int64_t t) {
+    // ширина, при которой внутренняя область еще не пуста
+    int64_t widest = (min(n, m) - 1) / 2;
+    double diff = double(n - m);
+    double root = sqrt(diff * diff + 4.0 * double(n * m - t));
+    int64_t w = min<int64_t>(widest, int64_t(double(t) / (double(n + m) + root)));
+    // площадь дорожки растет с шириной, поэтому хватает одного шага в каждую сторону
+    w += (w < widest) & (roadArea(n, m, w + 1) <= t);
+    w -= (w > 0) & (roadArea(n, m, w) > t);
+    return w;
+}
+
+// то же для сторон вплоть до 2^63 - 1: площади считаются в __int128, оценка - в long double
+int64_t maxPathWidthWide(int64_t n, int64_t m, int64_t t) {
+    int64_t widest = (min(n, m) - 1) / 2;
+    long double diff = (long double)n - m;
+    long double root = sqrtl(diff * diff + 4.0L * (long double)(__int128(n) * m - t));
+    int64_t w = int64_t(min<long double>(widest, (long double)t / ((long double)n + m + root)));
+    // точность long double - 64 бита, поэтому поправка может занять несколько шагов
+    while (w < widest && roadAreaWide(n, m, w + 1) <= t) ++w;
+    while (w > 0 && roadAreaWide(n, m, w) > t) --w;
+    return w;
+}
+
+// ширина дорожки для корректного запроса; 128-битный путь - только при переполнении n*m
+int64_t maxPathWidth(int64_t n, int64_t m, int64_t t) {
+    int64_t area;
+    if (__builtin_expect(__builtin_mul_overflow(n, m, &area), 0)) return maxPathWidthWide(n, m, t);
+    return maxPathWidthSafe(n, m, t);
+}
+
+// число запросов, решаемых пакетом одновременно (по одному в каждой полосе векторного регистра)
+const int queryLanes = 16;
+
+// подготовка пакета из queryLanes запросов без ветвлений: некорректные запросы и запросы
+// со стороной больше safeSide заменяются заведомо корректным (3 x 3, 1 плитка), чтобы ширины
+// можно было считать для всех полос подряд; valid - запрос корректен и решается в int64,
+// wide - запрос нужно решить maxPathWidthWide. возвращает true, если такие запросы есть
+inline bool prepareQueryLanes(const int64_t* n, const int64_t* m, const int64_t* t,
+                              int64_t* ns, int64_t* ms, int64_t* ts, bool* valid, bool* wide) {
+    bool anyWide = false;
+    for (int s = 0; s < queryLanes; ++s) {
+        bool basic = (n[s] >= 3) & (m[s] >= 3) & (t[s] >= 1);
+        bool safe = basic & (n[s] <= safeSide) & (m[s] <= safeSide);
+        ns[s] = safe ? n[s] : 3;
+        ms[s] = safe ? m[s] : 3;
+        valid[s] = safe & (t[s] < ns[s] * ms[s]);
+        ts[s] = valid[s] ? t[s] : 1;
+        wide[s] = basic & !safe;
+        anyWide |= wide[s];
+    }
+    return anyWide;
+}
+
+// решение пакета запросов: ответы для корректных запросов, -1 для остальных
+bool answerQueryBlock(const int64_t* n, const int64_t* m, const int64_t* t, int64_t* answers, bool* wide) {
+    int64_t ns[queryLanes], ms[queryLanes], ts[queryLanes];
+    bool valid[queryLanes];
+    bool anyWide = prepareQueryLanes(n, m, t, ns, ms, ts, valid, wide);
+    for (int s = 0; s < queryLanes; ++s) {
+        int64_t w = maxPathWidthSafe(ns[s], ms[s], ts[s]);
+        answers[s] = valid[s] ? w : -1;
+    }
+    return anyWide;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// gcc 12 ложно предупреждает о _mm512_undefined_* внутри встроенных функций avx-512
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+// то же с avx-512: по 8 запросов в регистре; avx-512dq дает умножение и преобразования int64 <-> double,
+// поправка оценки делается масками вместо сравнения roadArea <= t с переходом
+__attribute__((target("avx512f,avx512dq")))
+bool answerQueryBlockAvx512(const int64_t* n, const int64_t* m, const int64_t* t, int64_t* answers, bool* wide) {
+    alignas(64) int64_t ns[queryLanes], ms[queryLanes], ts[queryLanes];
+    bool valid[queryLanes];
+    bool anyWide = prepareQueryLanes(n, m, t, ns, ms, ts, valid, wide);
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512d four = _mm512_set1_pd(4.0);
+    for (int s = 0; s < queryLanes; s += 8) {
+        __m512i vn = _mm512_load_si512(ns + s);
+        __m512i vm = _mm512_load_si512(ms + s);
+        __m512i vt = _mm512_load_si512(ts + s);
+        __m512i sum = _mm512_add_epi64(vn, vm);
+        __m512i widest = _mm512_srai_epi64(_mm512_sub_epi64(_mm512_min_epi64(vn, vm), one), 1);
+        // оценка t / (s + sqrt((n-m)^2 + 4(nm - t)))
+        __m512d diff = _mm512_cvtepi64_pd(_mm512_sub_epi64(vn, vm));
+        __m512d rest = _mm512_cvtepi64_pd(_mm512_sub_epi64(_mm512_mullo_epi64(vn, vm), vt));
+        __m512d root = _mm512_sqrt_pd(_mm512_add_pd(_mm512_mul_pd(diff, diff), _mm512_mul_pd(four, rest)));
+        __m512d estimate = _mm512_div_pd(_mm512_cvtepi64_pd(vt), _mm512_add_pd(_mm512_cvtepi64_pd(sum), root));
+        __m512i w = _mm512_min_epi64(widest, _mm512_cvttpd_epi64(estimate));
+        // шаг вверх, если дорожка ширины w + 1 еще помещается: 2(w+1)(s - 2(w+1)) <= t
+        __m512i twice = _mm512_slli_epi64(_mm512_add_epi64(w, one), 1);
+        __m512i road = _mm512_mullo_epi64(twice, _mm512_sub_epi64(sum, twice));
+        __mmask8 up = _mm512_cmplt_epi64_mask(w, widest) & _mm512_cmple_epi64_mask(road, vt);
+        w = _mm512_mask_add_epi64(w, up, w, one);
+        // шаг вниз, если дорожка ширины w не помещается
+        twice = _mm512_slli_epi64(w, 1);
+        road = _mm512_mullo_epi64(twice, _mm512_sub_epi64(sum, twice));
+        __mmask8 down = _mm512_cmpgt_epi64_mask(w, zero) & _mm512_cmpgt_epi64_mask(road, vt);
+        w = _mm512_mask_sub_epi64(w, down, w, one);
+        _mm512_storeu_si512(answers + s, w);
+    }
+    for (int s = 0; s < queryLanes; ++s) answers[s] = valid[s] ? answers[s] : -1;
+    return anyWide;
+}
+#pragma GCC diagnostic pop
+#endif
+
+typedef bool (*QueryKernel)(const int64_t*, const int64_t*, const int64_t*, int64_t*, bool*);
+
+// выбор варианта по возможностям процессора
+QueryKernel selectQueryKernel() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return answerQueryBlockAvx512;
+#endif
+    return answerQueryBlock;
+}
+
+// запросы пакетного режима в виде структуры массивов: так их удобно читать полосами
+struct QueryBatch {
+    vector<int64_t> n, m, t;
+
+    size_t size() const { return n.size(); }
+};
+
+// быстрый разбор чисел из текста группами по Count (например, "n m t");
+// разделители - любые пробельные символы, onTuple получает массив из Count чисел
+template <int Count, typename OnTuple>
+bool parseTuples(const char* begin, const char* end, OnTuple onTuple) {
+    const char* p = begin;
+    int64_t values[Count];
+    int filled = 0;
+    while (true) {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+        if (p == end) break;
+        auto result = from_chars(p, end, values[filled]);
+        if (result.ec != errc()) {
+            cerr << "ошибка разбора числа в позиции " << (p - begin) << endl;
+            return false;
+        }
+        p = result.ptr;
+        if (++filled == Count) {
+            onTuple(values);
+            filled = 0;
+        }
+    }
+    if (filled != 0) {
+        cerr << "последняя запись неполна: нужно " << Count << " числа" << endl;
+        return false;
+    }
+    return true;
+}
+
+// разбор троек "n m t" в пакет запросов
+bool parseQueries(const char* begin, const char* end, QueryBatch& queries) {
+    return parseTuples<3>(begin, end, [&](const int64_t* values) {
+        queries.n.push_back(values[0]);
+        queries.m.push_back(values[1]);
+        queries.t.push_back(values[2]);
+    });
+}
+
+// чтение всего файла (или стандартного ввода при имени "-") в память
+bool readAll(const string& filename, vector<char>& data) {
+    FILE* file = filename == "-" ? stdin : fopen(filename.c_str(), "rb");
+    if (!file) {
+        cerr << "ошибка при открытии файла " << filename << endl;
+        return false;
+    }
+    char chunk[1 << 16];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + got);
+    bool ok = !ferror(file);
+    if (file != stdin) fclose(file);
+    if (!ok) cerr << "ошибка при чтении файла " << filename << endl;
+    return ok;
+}
+
+// ответы на все запросы в threadCount потоках пакетами по queryLanes; некорректный запрос получает ответ -1
+void answerQueries(const QueryBatch& queries, vector<int64_t>& answers, int threadCount) {
+    LR6_PROFILE_ZONE("answerQueries");
+    size_t count = queries.size();
+    answers.resize(count);
+    size_t blocks = (count + queryLanes - 1) / queryLanes;
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    threadCount = int(max<size_t>(1, min<size_t>(threadCount, blocks / 256 + 1)));
+    QueryKernel kernel = selectQueryKernel();
+    auto worker = [&](int index) {
+        size_t firstBlock = blocks * index / threadCount;
+        size_t lastBlock = blocks * (index + 1) / threadCount;
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            size_t first = block * queryLanes;
+            size_t lanes = min<size_t>(queryLanes, count - first);
+            int64_t* out = answers.data() + first;
+            bool wide[queryLanes];
+            bool anyWide;
+            if (lanes == queryLanes) {
+                anyWide = kernel(&queries.n[first], &queries.m[first], &queries.t[first], out, wide);
+            } else {
+                // неполный последний пакет дополняется корректными запросами
+                int64_t n[queryLanes], m[queryLanes], t[queryLanes], tail[queryLanes];
+                for (int s = 0; s < queryLanes; ++s) {
+                    bool used = size_t(s) < lanes;
+                    n[s] = used ? queries.n[first + s] : 3;
+                    m[s] = used ? queries.m[first + s] : 3;
+                    t[s] = used ? queries.t[first + s] : 1;
+                }
+                anyWide = kernel(n, m, t, tail, wide);
+                copy(tail, tail + lanes, out);
+            }
+            // редкие запросы со сторонами больше safeSide решаются в 128-битной арифметике
+            if (anyWide) {
+                for (size_t s = 0; s < lanes; ++s) {
+                    if (!wide[s]) continue;
+                    int64_t n = queries.n[first + s], m = queries.m[first + s], t = queries.t[first + s];
+                    out[s] = validateQuery(n, m, t) ? -1 : maxPathWidthWide(n, m, t);
+                }
+            }
+        }
+    };
+    vector<thread> threads;
+    for (int index = 1; index < threadCount; ++index) threads.emplace_back(worker, index);
+    worker(0);
+    for (auto& t : threads) t.join();
+}
+
+// пакетный режим: запросы из файла (или "-" для стандартного ввода), ответы по одному в строке
+int runBatch(int argc, char* argv[]) {
+    string filename = argc > 2 ? argv[2] : "-";
+    int threadCount = argc > 3 ? atoi(argv[3]) : 0;
+
+    auto start = chrono::steady_clock::now();
+    vector<char> input;
+    QueryBatch queries;
+    if (!readAll(filename, input) || !parseQueries(input.data(), input.data() + input.size(), queries)) return 1;
+    auto parsed = chrono::steady_clock::now();
+
+    vector<int64_t> answers;
+    answerQueries(queries, answers, threadCount);
+    auto solved = chrono::steady_clock::now();
+
+    OutputBuffer out(cout);
+    size_t invalid = 0;
+    for (int64_t answer : answers) {
+        invalid += answer < 0;
+        out.writeInteger(answer);
+        out.put('\n');
+    }
+    out.flush();
+    // статистика - в поток ошибок, чтобы не смешивать с ответами
+    cerr << "запросов: " << queries.size() << ", некорректных: " << invalid
+         << ", разбор " << chrono::duration<double>(parsed - start).count() << " с"
+         << ", решение " << chrono::duration<double>(solved - parsed).count() << " с" << endl;
+    return 0;
+}
+
+// индекс ширин для повторяющихся полей: для каждого поля (n, m) хранится возрастающая таблица
+// площадей дорожек roadArea(n, m, w) для w = 1..widest, и ответ на запрос с любым t -
+// число площадей, не превышающих t. формат файла (little-endian):
+//   сигнатура, число полей, общее число площадей (uint64),
+//   записи полей IndexedGrid, упорядоченные по (n, m),
+//   площади int64 всех полей подряд.
+// файл отображается в память; при открытии проверяются размеры и записи полей,
+// площади используются без разбора
+const char widthIndexMagic[8] = {'L', 'R', '6', 'W', 'I', 'D', 'X', '\0'};
+
+// запись поля в индексе
+struct IndexedGrid {
+    int64_t n, m;    // размеры поля
+    uint64_t first;  // номер первой площади поля в общей таблице
+    uint64_t count;  // число площадей (= наибольшая допустимая ширина)
+};
+
+// заголовок файла индекса
+struct WidthIndexHeader {
+    char magic[8];
+    uint64_t gridCount;
+    uint64_t areaCount;
+};
+
+// поля с таблицей длиннее этого предела в индекс не попадают: для них хватает решения за O(1)
+const int64_t maxIndexedWidths = int64_t(1) << 20;
+
+// отображенный в память индекс ширин
+class WidthIndex {
+public:
+    ~WidthIndex() { close(); }
+
+    // открытие файла индекса с проверкой сигнатуры, размеров и записей полей
+    bool open(const string& filename) {
+        descriptor = ::open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (descriptor < 0 || fstat(descriptor, &info) != 0 || size_t(info.st_size) < sizeof(WidthIndexHeader)) {
+            cerr << "ошибка при открытии индекса " << filename << endl;
+            close();
+            return false;
+        }
+        size = size_t(info.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED) {
+            cerr << "ошибка при отображении индекса " << filename << endl;
+            close();
+            return false;
+        }
+        data = static_cast<const char*>(address);
+        const WidthIndexHeader* header = reinterpret_cast<const WidthIndexHeader*>(data);
+        // размеры сверяем делением, чтобы огромные счетчики из поврежденного заголовка
+        // не переполнили произведение
+        size_t payload = size - sizeof(WidthIndexHeader);
+        bool sizesMatch = header->gridCount <= payload / sizeof(IndexedGrid) &&
+                          (payload - header->gridCount * sizeof(IndexedGrid)) % sizeof(int64_t) == 0 &&
+                          header->areaCount == (payload - header->gridCount * sizeof(IndexedGrid)) / sizeof(int64_t);
+        if (memcmp(header->magic, widthIndexMagic, sizeof(widthIndexMagic)) != 0 || !sizesMatch) {
+            cerr << "файл " << filename << " не является индексом ширин" << endl;
+            close();
+            return false;
+        }
+        grids = reinterpret_cast<const IndexedGrid*>(data + sizeof(WidthIndexHeader));
+        gridCount = header->gridCount;
+        areas = reinterpret_cast<const int64_t*>(grids + gridCount);
+        // таблица каждого поля - внутри файла, поля строго упорядочены по (n, m) для двоичного поиска
+        for (size_t i = 0; i < gridCount; ++i) {
+            const IndexedGrid& grid = grids[i];
+            bool inside = grid.first <= header->areaCount && grid.count <= header->areaCount - grid.first;
+            bool ordered = i == 0 || make_pair(grids[i - 1].n, grids[i - 1].m) < make_pair(grid.n, grid.m);
+            if (!inside || !ordered) {
+                cerr << "индекс " << filename << " поврежден: запись поля " << i + 1
+                     << (inside ? " нарушает порядок полей" : " ссылается за пределы таблицы площадей") << endl;
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // снятие отображения и закрытие файла
+    void close() {
+        if (data) munmap(const_cast<char*>(data), size);
+        if (descriptor >= 0) ::close(descriptor);
+        data = nullptr;
+        descriptor = -1;
+        size = gridCount = 0;
+    }
+
+    // поле (n, m) в индексе или nullptr
+    const IndexedGrid* findGrid(int64_t n, int64_t m) const {
+        const IndexedGrid* end = grids + gridCount;
+        const IndexedGrid* grid = lower_bound(grids, end, make_pair(n, m),
+                                              [](const IndexedGrid& g, const pair<int64_t, int64_t>& key) {
+                                                  return make_pair(g.n, g.m) < key;
+                                              });
+        return grid != end && grid->n == n && grid->m == m ? grid : nullptr;
+    }
+
+    // ширина дорожки для корректного запроса по таблице поля
+    int64_t width(const IndexedGrid& grid, int64_t t) const {
+        const int64_t* first = areas + grid.first;
+        return upper_bound(first, first + grid.count, t) - first;
+    }
+
+    // число полей в индексе
+    size_t gridTotal() const { return gridCount; }
+
+private:
+    const char* data = nullptr;        // начало отображения
+    size_t size = 0;                   // размер файла
+    int descriptor = -1;               // дескриптор файла
+    const IndexedGrid* grids = nullptr; // записи полей
+    size_t gridCount = 0;              // число полей
+    const int64_t* areas = nullptr;    // площади всех полей
+};
+
+// построение индекса для полей из файла gridsFile (пары "n m") и запись его в indexFile
+int runBuildIndex(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "использование: " << argv[0] << " --build-index <файл полей|-> <файл индекса>" << endl;
+        return 1;
+    }
+    vector<char> input;
+    vector<pair<int64_t, int64_t>> fields;
+    if (!readAll(argv[2], input) ||
+        !parseTuples<2>(input.data(), input.data() + input.size(),
+                        [&](const int64_t* values) { fields.push_back({values[0], values[1]}); }))
+        return 1;
+    sort(fields.begin(), fields.end());
+    fields.erase(unique(fields.begin(), fields.end()), fields.end());
+
+    // таблицы площадей: площадь растет с шириной, поэтому таблица упорядочена
+    vector<IndexedGrid> grids;
+    vector<int64_t> areas;
+    size_t skipped = 0;
+    for (auto [n, m] : fields) {
+        int64_t area;
+        int64_t widest = (min(n, m) - 1) / 2;
+        if (n < 3 || m < 3 || __builtin_mul_overflow(n, m, &area) || widest > maxIndexedWidths) {
+            skipped++;
+            continue;
+        }
+        grids.push_back({n, m, uint64_t(areas.size()), uint64_t(widest)});
+        for (int64_t w = 1; w <= widest; ++w) areas.push_back(roadArea(n, m, w));
+    }
+
+    FILE* file = fopen(argv[3], "wb");
+    if (!file) {
+        cerr << "ошибка при создании файла " << argv[3] << endl;
+        return 1;
+    }
+    WidthIndexHeader header;
+    memcpy(header.magic, widthIndexMagic, sizeof(header.magic));
+    header.gridCount = grids.size();
+    header.areaCount = areas.size();
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(grids.data(), sizeof(IndexedGrid), grids.size(), file) == grids.size() &&
+              fwrite(areas.data(), sizeof(int64_t), areas.size(), file) == areas.size();
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        cerr << "ошибка при записи файла " << argv[3] << endl;
+        return 1;
+    }
+    cerr << "полей в индексе: " << grids.size() << ", площадей: " << areas.size()
+         << ", пропущено (некорректные или слишком большие): " << skipped << endl;
+    return 0;
+}
+
+// ответы на запросы по индексу; поля, которых нет в индексе, решаются за O(1)
+int runIndexQueries(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "использование: " << argv[0] << " --query-index <файл индекса> [файл запросов|-] [потоки]" << endl;
+        return 1;
+    }
+    string filename = argc > 3 ? argv[3] : "-";
+    int threadCount = argc > 4 ? atoi(argv[4]) : 0;
+
+    auto start = chrono::steady_clock::now();
+    WidthIndex widthIndex;
+    vector<char> input;
+    QueryBatch queries;
+    if (!widthIndex.open(argv[2]) || !readAll(filename, input) ||
+        !parseQueries(input.data(), input.data() + input.size(), queries))
+        return 1;
+    auto parsed = chrono::steady_clock::now();
+
+    size_t count = queries.size();
+    vector<int64_t> answers(count);
+    if (threadCount <= 0) threadCount = max(1u, thread::hardware_concurrency());
+    threadCount = int(max<size_t>(1, min<size_t>(threadCount, count / 4096 + 1)));
+    vector<size_t> misses(threadCount, 0);
+    auto worker = [&](int index) {
+        size_t first = count * index / threadCount;
+        size_t last = count * (index + 1) / threadCount;
+        // запросы к одному полю обычно идут подряд - запоминаем последнее найденное поле
+        const IndexedGrid* cached = nullptr;
+        for (size_t i = first; i < last; ++i) {
+            int64_t n = queries.n[i], m = queries.m[i], t = queries.t[i];
+            if (validateQuery(n, m, t)) {
+                answers[i] = -1;
+                continue;
+            }
+            if (!cached || cached->n != n || cached->m != m) cached = widthIndex.findGrid(n, m);
+            if (cached) {
+                answers[i] = widthIndex.width(*cached, t);
+            } else {
+                answers[i] = maxPathWidth(n, m, t);
+                misses[index]++;
+            }
+        }
+    };
+    vector<thread> threads;
+    for (int i = 1; i < threadCount; ++i) threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& t : threads) t.join();
+    auto solved = chrono::steady_clock::now();
+
+    OutputBuffer out(cout);
+    for (int64_t answer : answers) {
+        out.writeInteger(answer);
+        out.put('\n');
+    }
+    out.flush();
+    size_t missed = 0;
+    for (size_t value : misses) missed += value;
+    cerr << "запросов: " << count << ", полей в индексе: " << widthIndex.gridTotal() << ", вне индекса: " << missed
+         << ", разбор " << chrono::duration<double>(parsed - start).count() << " с"
+         << ", решение " << chrono::duration<double>(solved - parsed).count() << " с" << endl;
+    return 0;
+}
+
+// без main, когда файл подключается в общий стенд замеров lr6-bench.cpp
+#ifndef LR6_NO_MAIN
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--build-index") {
+        return runBuildIndex(argc, argv);
+    }
+    if (argc > 1 && string(argv[1]) == "--query-index") {
+        return runIndexQueries(argc, argv);
+    }
+
+    int64_t n, m, t; // объявление переменных для размеров площади и количества плиток
+
+    // чтение входных данных
+    cin >> n >> m >> t;
+
+    // проверка входных данных
+    if (const char* error = validateQuery(n, m, t)) {
+        cout << error << endl;
+        return 1; // завершение программы с кодом ошибки
+    }
 
     // вывод результата
-    cout << maxWidth << endl;
+    cout << maxPathWidth(n, m, t) << endl;
 
-    return 0; 
+    return 0;
 }
+#endif
@@ -1,48 +1,8 @@
-use std::io;
+use std::io::{self, Read, Write};
 
 
-fn main() {
-    let mut n: i64 = 0;
-    let mut m: i64 = 0;
-    let mut t: i64 = 0;
-
-    // создаем строку для чтения входных данных
-    let mut input = String::new();
-
-    // читаем первую строку с входными данными
-    io::stdin().read_line(&mut input).expect("не удалось прочитать строку");
-    // разбиваем строку по пробелам и парсим числа
-    let parts: Vec<&str> = input.trim().split_whitespace().collect();
-
-    // проверяем, что введено ровно три числа
-    if parts.len() != 3 {
-        println!("Ошибка: необходимо ввести три числа: n, m, t");
-        return;
-    }
-
-    // парсим числа из строки
-    n = parts[0].parse().expect("не удалось преобразовать n в число");
-    m = parts[1].parse().expect("не удалось преобразовать m в число");
-    t = parts[2].parse().expect("не удалось преобразовать t в число");
-
-    // проверка, чтобы размеры были не меньше 3
-    if n < 3 || m < 3 {
-        println!("Ошибка: размеры площади должны быть ≥ 3");
-        return; // завершение программы
-    }
-
-    // проверка, чтобы количество плиток было не меньше 1
-    if t < 1 {
-        println!("Ошибка: количество плиток должно быть ≥ 1");
-        return; // завершение программы
-    }
-
-    // проверка, чтобы плиток не было слишком много (не покрывали бы всю площадь)
-    if t >= n * m {
-        println!("Ошибка: плиток слишком много, они покрывают всю площадь");
-        return; // завершение программы
-    }
-
+// наибольшая ширина дорожки бинарным поиском (запрос должен быть корректным)
+fn max_path_width(n: i64, m: i64, t: i64) -> i64 {
     // устанавливаем границы бинарного поиска для ширины дорожки
     // левая граница — 0 (минимальная ширина)
     let mut left: i64 = 0;
@@ -87,6 +47,94 @@ fn main() {
         }
     }
 
+    max_width
+}
+
+// пакетный режим (для сверки с реализацией на c++): запросы "n m t" со стандартного ввода,
+// ответы по одному в строке, -1 для некорректного запроса
+fn run_batch() {
+    let mut input = String::new();
+    io::stdin().read_to_string(&mut input).expect("не удалось прочитать запросы");
+    let numbers: Vec<i64> = input
+        .split_whitespace()
+        .map(|token| token.parse().expect("не удалось преобразовать число"))
+        .collect();
+    if numbers.len() % 3 != 0 {
+        eprintln!("Ошибка: число значений не кратно трем");
+        std::process::exit(1);
+    }
+
+    let start = std::time::Instant::now();
+    let answers: Vec<i64> = numbers
+        .chunks(3)
+        .map(|query| {
+            let (n, m, t) = (query[0], query[1], query[2]);
+            // те же проверки, что и в диалоговом режиме; n*m может не поместиться в i64
+            let covers_all = n.checked_mul(m).map_or(false, |area| t >= area);
+            if n < 3 || m < 3 || t < 1 || covers_all { -1 } else { max_path_width(n, m, t) }
+        })
+        .collect();
+    let seconds = start.elapsed().as_secs_f64();
+
+    let mut output = String::with_capacity(answers.len() * 8);
+    for answer in &answers {
+        output.push_str(&answer.to_string());
+        output.push('\n');
+    }
+    io::stdout().write_all(output.as_bytes()).expect("не удалось записать ответы");
+    let invalid = answers.iter().filter(|&&answer| answer < 0).count();
+    eprintln!("запросов: {}, некорректных: {}, решение {} с", answers.len(), invalid, seconds);
+}
+
+fn main() {
+    if std::env::args().nth(1).as_deref() == Some("--batch") {
+        run_batch();
+        return;
+    }
+
+    let mut n: i64 = 0;
+    let mut m: i64 = 0;
+    let mut t: i64 = 0;
+
+    // создаем строку для чтения входных данных
+    let mut input = String::new();
+
+    // читаем первую строку с входными данными
+    io::stdin().read_line(&mut input).expect("не удалось прочитать строку");
+    // разбиваем строку по пробелам и парсим числа
+    let parts: Vec<&str> = input.trim().split_whitespace().collect();
+
+    // проверяем, что введено ровно три числа
+    if parts.len() != 3 {
+        println!("Ошибка: необходимо ввести три числа: n, m, t");
+        return;
+    }
+
+    // парсим числа из строки
+    n = parts[0].parse().expect("не удалось преобразовать n в число");
+    m = parts[1].parse().expect("не удалось преобразовать m в число");
+    t = parts[2].parse().expect("не удалось преобразовать t в число");
+
+    // проверка, чтобы размеры были не меньше 3
+    if n < 3 || m < 3 {
+        println!("Ошибка: размеры площади должны быть ≥ 3");
+        return; // завершение программы
+    }
+
+    // проверка, чтобы количество плиток было не меньше 1
+    if t < 1 {
+        println!("Ошибка: количество плиток должно быть ≥ 1");
+        return; // завершение программы
+    }
+
+    // проверка, чтобы плиток не было слишком много (не покрывали бы всю площадь)
+    if t >= n * m {
+        println!("Ошибка: плиток слишком много, они покрывают всю площадь");
+        return; // завершение программы
+    }
+
+    let max_width = max_path_width(n, m, t);
+
     // выводим найденное максимальное значение ширины дорожки
     println!("{}", max_width);
 }
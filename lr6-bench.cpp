@@ -0,0 +1,552 @@
+// общий стенд замеров для программ лабораторной работы 6: ядра lr6-1..lr6-4
+// запускаются на параметризованных нагрузках с прогревом и повторами,
+// результаты (перцентили времени, пропускная способность, счетчики ядра ОС
+// и аппаратные счетчики perf_event_open, если они доступны)
+// выводятся таблицей и сохраняются в json для отслеживания регрессий
+//
+// сборка: g++ -std=c++17 -O2 -pthread -o lr6-bench lr6-bench.cpp
+// (с -DLR6_PROFILE при выходе печатается еще и профиль зон горячих функций)
+// запуск: lr6-bench [--filter подстрока] [--warmup n] [--repetitions n] [--scale k]
+//                   [--threads n] [--json файл] [--list]
+
+// стандартные заголовки всех программ подключаются здесь, вне пространств имен,
+// поэтому повторные #include внутри программ ничего не добавляют
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "lr6-output.h"
+#include "lr6-profile.h"
+
+// каждая программа подключается без main в собственное пространство имен,
+// чтобы одноименные функции разных программ не конфликтовали
+#define LR6_NO_MAIN
+namespace lr61 {
+#include "lr6-1.cpp"
+}
+namespace lr62 {
+#include "lr6-2.cpp"
+}
+namespace lr63 {
+#include "lr6-3.cpp"
+}
+namespace lr64 {
+#include "lr6-4.cpp"
+}
+
+using namespace std;
+
+// параметры запуска
+struct BenchmarkOptions {
+    string filter;             // выполнять только нагрузки, в имени которых есть подстрока
+    int warmup = 2;            // прогревочные запуски (не учитываются)
+    int repetitions = 10;      // замеряемые запуски
+    double scale = 1.0;        // множитель размеров нагрузок
+    int threadCount = 0;       // потоки для многопоточных ядер (0 - все ядра)
+    string jsonFile = "lr6-bench.json";
+    bool listOnly = false;     // только вывести список нагрузок
+};
+
+// подготовленная нагрузка: данные захватываются в run, который возвращает
+// контрольную сумму результата (она же не дает компилятору выбросить вычисления)
+struct PreparedWorkload {
+    double items = 0;  // обработанных элементов за запуск
+    string details;    // то, что известно только после подготовки (дописывается к параметрам)
+    function<uint64_t()> run;
+};
+
+// нагрузка: описание известно сразу, а данные готовит setup - только для нагрузок,
+// прошедших фильтр, и непосредственно перед их замерами
+struct Workload {
+    string name;        // программа/ядро
+    string parameters;  // описание размеров
+    string unit;        // единица элементов
+    function<PreparedWorkload()> setup;
+};
+
+// счетчики ядра ОС за время всех замеряемых запусков
+struct SystemCounters {
+    double userSeconds = 0;     // процессорное время в режиме пользователя
+    double systemSeconds = 0;   // процессорное время в ядре
+    long minorFaults = 0;       // страничные прерывания без чтения с диска
+    long majorFaults = 0;       // страничные прерывания с чтением с диска
+    long voluntarySwitches = 0; // добровольные переключения контекста
+    long forcedSwitches = 0;    // вытеснения
+};
+
+// текущие счетчики процесса (всех потоков)
+SystemCounters readSystemCounters() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    SystemCounters counters;
+    counters.userSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6;
+    counters.systemSeconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+    counters.minorFaults = usage.ru_minflt;
+    counters.majorFaults = usage.ru_majflt;
+    counters.voluntarySwitches = usage.ru_nvcsw;
+    counters.forcedSwitches = usage.ru_nivcsw;
+    return counters;
+}
+
+// разность счетчиков after - before
+SystemCounters operator-(const SystemCounters& after, const SystemCounters& before) {
+    SystemCounters delta;
+    delta.userSeconds = after.userSeconds - before.userSeconds;
+    delta.systemSeconds = after.systemSeconds - before.systemSeconds;
+    delta.minorFaults = after.minorFaults - before.minorFaults;
+    delta.majorFaults = after.majorFaults - before.majorFaults;
+    delta.voluntarySwitches = after.voluntarySwitches - before.voluntarySwitches;
+    delta.forcedSwitches = after.forcedSwitches - before.forcedSwitches;
+    return delta;
+}
+
+// результат замеров одной нагрузки
+struct WorkloadResult {
+    string name;
+    string parameters;
+    string unit;
+    double items = 0;
+    vector<double> seconds;   // время каждого замеряемого запуска
+    uint64_t checksum = 0;    // контрольная сумма (одинакова во всех запусках)
+    bool stable = true;       // контрольные суммы всех запусков совпали
+    SystemCounters counters;  // счетчики ОС за все замеряемые запуски
+    bool hasHardware = false; // удалось ли открыть аппаратные счетчики
+    lr6profile::CounterValues hardware; // такты, инструкции, промахи кэша за все замеряемые запуски
+};
+
+// дополнение пробелами до width символов utf-8 (setw считает байты, и кириллица сбивает
+// колонки); отрицательная ширина - выравнивание влево
+string padded(const string& text, int width) {
+    int length = 0;
+    for (unsigned char c : text) length += (c & 0xC0) != 0x80;
+    string padding(size_t(max(0, abs(width) - length)), ' ');
+    return width < 0 ? text + padding : padding + text;
+}
+
+// перцентиль p (0..100) по отсортированной выборке методом ближайшего ранга
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = size_t(ceil(p / 100.0 * sorted.size()));
+    return sorted[min(sorted.size(), max<size_t>(rank, 1)) - 1];
+}
+
+// подготовка, прогрев и замеры одной нагрузки (данные освобождаются после замеров)
+WorkloadResult measure(const Workload& workload, const BenchmarkOptions& options) {
+    PreparedWorkload prepared = workload.setup();
+    WorkloadResult result;
+    result.name = workload.name;
+    result.parameters = workload.parameters + prepared.details;
+    result.unit = workload.unit;
+    result.items = prepared.items;
+    for (int i = 0; i < options.warmup; ++i) result.checksum = prepared.run();
+
+    // счетчики открываются до замеров и учитывают потоки, которые создаст ядро
+    lr6profile::HardwareCounters hardware(true);
+    lr6profile::CounterValues hardwareBefore = hardware.read();
+    SystemCounters before = readSystemCounters();
+    for (int i = 0; i < options.repetitions; ++i) {
+        auto start = chrono::steady_clock::now();
+        uint64_t checksum = prepared.run();
+        result.seconds.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        if (i == 0 && options.warmup == 0) result.checksum = checksum;
+        if (checksum != result.checksum) result.stable = false;
+    }
+    result.counters = readSystemCounters() - before;
+    result.hasHardware = hardware.available();
+    if (result.hasHardware) result.hardware = hardware.read() - hardwareBefore;
+    return result;
+}
+
+// смешивание 64-битных значений в контрольную сумму
+inline uint64_t mixChecksum(uint64_t hash, uint64_t value) {
+    hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+// размер, умноженный на масштаб (не меньше minimum)
+int64_t scaled(double size, const BenchmarkOptions& options, int64_t minimum = 1) {
+    return max<int64_t>(minimum, int64_t(llround(size * options.scale)));
+}
+
+// нагрузки lr6-1: генерация матрицы, подсчет элементов, поиск серий, метод Монте-Карло
+void addMatrixWorkloads(vector<Workload>& workloads, const BenchmarkOptions& options) {
+    int side = int(scaled(2000, options, 5));
+    int threads = options.threadCount;
+    string shape = to_string(side) + "x" + to_string(side);
+    double elements = double(side) * side;
+
+    workloads.push_back({"lr6-1/createMatrix", shape + " 0..100", "elements", [=] {
+        return PreparedWorkload{elements, "", [=] {
+            lr61::MatrixArena arena;
+            lr61::IntMatrix matrix = lr61::createMatrix(arena, side, side, 0, 100, 2024, threads);
+            return uint64_t(matrix.row(side - 1)[side - 1]);
+        }};
+    }});
+
+    // узкий диапазон из задания (плотные счетчики) и широкий (хеш-таблица)
+    for (int maxVal : {100, 1000000000}) {
+        // матрица в своей арене; создается при подготовке нагрузки
+        auto makeMatrix = [=] {
+            auto arena = make_shared<lr61::MatrixArena>();
+            auto matrix = make_shared<lr61::IntMatrix>(lr61::createMatrix(*arena, side, side, 0, maxVal, 2024, threads));
+            return make_pair(arena, matrix);
+        };
+        string range = shape + " 0.." + to_string(maxVal);
+        workloads.push_back({"lr6-1/countUniqueElements", range, "elements", [=] {
+            auto [arena, matrix] = makeMatrix();
+            return PreparedWorkload{elements, "", [=] {
+                lr61::ElementCounts counts = lr61::countUniqueElements(*matrix, threads);
+                (void)arena;
+                return mixChecksum(counts.size(), counts.empty() ? 0 : uint64_t(counts.back().second));
+            }};
+        }});
+        workloads.push_back({"lr6-1/findIncreasingSequence", range, "elements", [=] {
+            auto [arena, matrix] = makeMatrix();
+            return PreparedWorkload{elements, "", [=] {
+                vector<int> sequence = lr61::findIncreasingSequence(*matrix, threads);
+                (void)arena;
+                return mixChecksum(sequence.size(), sequence.empty() ? 0 : uint64_t(sequence.back()));
+            }};
+        }});
+    }
+
+    int64_t positions = scaled(1000000, options);
+    workloads.push_back({"lr6-1/evaluateRandomPositions", to_string(positions) + " positions", "positions", [=] {
+        return PreparedWorkload{double(positions), "", [=] {
+            lr61::AttackStatistics statistics = lr61::evaluateRandomPositions(positions, 7, threads);
+            return mixChecksum(uint64_t(statistics.checks), uint64_t(statistics.multipleChecks));
+        }};
+    }});
+}
+
+// ключ, iv и случайные данные для нагрузок lr6-2 (одинаковые при каждой подготовке)
+struct CipherInput {
+    array<uint8_t, 16> key;
+    array<uint8_t, 16> iv;
+    vector<uint8_t> data;
+};
+
+shared_ptr<CipherInput> makeCipherInput(size_t bytes, uint64_t seed) {
+    auto input = make_shared<CipherInput>();
+    mt19937_64 generator(seed);
+    for (auto& byte : input->key) byte = uint8_t(generator());
+    for (auto& byte : input->iv) byte = uint8_t(generator());
+    input->data.resize(bytes);
+    for (auto& byte : input->data) byte = uint8_t(generator());
+    return input;
+}
+
+// нагрузки lr6-2: режим OFB с трассировкой и пакетные режимы ECB/CBC
+void addCipherWorkloads(vector<Workload>& workloads, const BenchmarkOptions& options) {
+    int threads = options.threadCount;
+
+    // OFB пишет состояние каждого раунда в поток, поэтому объем данных небольшой
+    size_t ofbBytes = size_t(scaled(16 << 10, options, 16));
+    workloads.push_back({"lr6-2/processInOFBMode", to_string(ofbBytes) + " bytes", "bytes", [=] {
+        auto input = makeCipherInput(ofbBytes, 42);
+        return PreparedWorkload{double(ofbBytes), "", [=] {
+            vector<uint8_t> output(input->data.size());
+            stringstream trace;
+            lr62::processInOFBMode(input->key.data(), input->iv.data(), input->data.data(), output.data(),
+                                   output.size(), trace);
+            return mixChecksum(output.back(), trace.str().size());
+        }};
+    }});
+
+    size_t bulkBytes = size_t(scaled(16 << 20, options, 16));
+    string bytesText = to_string(bulkBytes) + " bytes";
+    workloads.push_back({"lr6-2/EncryptECB", bytesText, "bytes", [=] {
+        auto input = makeCipherInput(bulkBytes, 43);
+        auto schedule = make_shared<lr62::KeySchedule>(lr62::makeKeySchedule(input->key.data()));
+        return PreparedWorkload{double(bulkBytes), "", [=] {
+            vector<uint8_t> output = lr62::EncryptECB(*schedule, input->data.data(), input->data.size(), threads);
+            return mixChecksum(output.size(), output[output.size() / 2]);
+        }};
+    }});
+    workloads.push_back({"lr6-2/EncryptCBC", bytesText, "bytes", [=] {
+        auto input = makeCipherInput(bulkBytes, 43);
+        auto schedule = make_shared<lr62::KeySchedule>(lr62::makeKeySchedule(input->key.data()));
+        return PreparedWorkload{double(bulkBytes), "", [=] {
+            vector<uint8_t> output = lr62::EncryptCBC(*schedule, input->iv.data(), input->data.data(),
+                                                      input->data.size());
+            return mixChecksum(output.size(), output.back());
+        }};
+    }});
+    workloads.push_back({"lr6-2/DecryptCBC", bytesText, "bytes", [=] {
+        auto input = makeCipherInput(bulkBytes, 43);
+        auto schedule = make_shared<lr62::KeySchedule>(lr62::makeKeySchedule(input->key.data()));
+        auto cipherText = make_shared<vector<uint8_t>>(
+            lr62::EncryptCBC(*schedule, input->iv.data(), input->data.data(), input->data.size()));
+        return PreparedWorkload{double(bulkBytes), "", [=] {
+            vector<uint8_t> output;
+            bool ok = lr62::DecryptCBC(*schedule, input->iv.data(), cipherText->data(), cipherText->size(), output,
+                                       threads);
+            return mixChecksum(ok, output.empty() ? 0 : output.back());
+        }};
+    }});
+}
+
+// контрольная сумма решения системы
+uint64_t solutionChecksum(const vector<double>& solution) {
+    uint64_t hash = solution.size();
+    // решение точное до epsilon: округляем, чтобы сумма не зависела от последних битов
+    for (double value : solution) hash = mixChecksum(hash, uint64_t(llround(value * 1e4)));
+    return hash;
+}
+
+// нагрузки lr6-3: прямой и итерационные методы на системе с диагональным преобладанием
+void addSolverWorkloads(vector<Workload>& workloads, const BenchmarkOptions& options) {
+    int gaussSize = int(scaled(300, options, 2));
+    workloads.push_back({"lr6-3/solveGauss", "n=" + to_string(gaussSize) + " dense", "flops", [=] {
+        auto matrixA = make_shared<vector<vector<double>>>();
+        auto vectorB = make_shared<vector<double>>();
+        lr63::generateTestSystem(lr63::TestMatrixKind::DenseDominant, gaussSize, 20240601, *matrixA, *vectorB);
+        double n = gaussSize;
+        return PreparedWorkload{2.0 * n * n * n / 3.0, "", [=] {
+            return solutionChecksum(lr63::solveGauss(*matrixA, *vectorB, false));
+        }};
+    }});
+
+    const double epsilon = 1e-6;
+    const int maxIterations = 1000;
+    for (auto [name, seidel] : {pair<const char*, bool>{"lr6-3/solveJacobi", false}, {"lr6-3/solveSeidel", true}}) {
+        int size = int(scaled(1000, options, 2));
+        workloads.push_back({name, "n=" + to_string(size) + " dense", "flops", [=] {
+            auto matrixA = make_shared<vector<vector<double>>>();
+            auto vectorB = make_shared<vector<double>>();
+            lr63::generateTestSystem(lr63::TestMatrixKind::DenseDominant, size, 20240601 + size, *matrixA, *vectorB);
+            // число итераций известно только после решения: считаем его один раз заранее
+            int iterations = 0;
+            if (seidel) {
+                lr63::solveSeidel(*matrixA, *vectorB, epsilon, maxIterations, false, &iterations);
+            } else {
+                lr63::solveJacobi(*matrixA, *vectorB, epsilon, maxIterations, false, &iterations);
+            }
+            double flops = 2.0 * size * size * max(iterations, 1);
+            return PreparedWorkload{flops, ", " + to_string(iterations) + " iterations", [=] {
+                int used = 0;
+                vector<double> solution =
+                    seidel ? lr63::solveSeidel(*matrixA, *vectorB, epsilon, maxIterations, false, &used)
+                           : lr63::solveJacobi(*matrixA, *vectorB, epsilon, maxIterations, false, &used);
+                return mixChecksum(solutionChecksum(solution), uint64_t(used));
+            }};
+        }});
+    }
+}
+
+// корректные запросы lr6-4: поле до 10^6 x 10^6, площадь дорожки заведомо меньше площади поля
+shared_ptr<lr64::QueryBatch> makeQueries(size_t count) {
+    auto queries = make_shared<lr64::QueryBatch>();
+    mt19937_64 generator(4);
+    for (size_t i = 0; i < count; ++i) {
+        int64_t n = 3 + int64_t(generator() % 1000000);
+        int64_t m = 3 + int64_t(generator() % 1000000);
+        int64_t t = 1 + int64_t(generator() % uint64_t(n * m - 1));
+        queries->n.push_back(n);
+        queries->m.push_back(m);
+        queries->t.push_back(t);
+    }
+    return queries;
+}
+
+// контрольная сумма ответов на запросы
+uint64_t answersChecksum(const vector<int64_t>& answers) {
+    uint64_t hash = answers.size();
+    for (int64_t answer : answers) hash = mixChecksum(hash, uint64_t(answer));
+    return hash;
+}
+
+// нагрузки lr6-4: пакетные ответы на запросы и исходный бинарный поиск
+void addWidthWorkloads(vector<Workload>& workloads, const BenchmarkOptions& options) {
+    size_t count = size_t(scaled(1 << 20, options));
+    int threads = options.threadCount;
+    string queryText = to_string(count) + " queries";
+
+    workloads.push_back({"lr6-4/answerQueries", queryText, "queries", [=] {
+        auto queries = makeQueries(count);
+        return PreparedWorkload{double(count), "", [=] {
+            vector<int64_t> answers;
+            lr64::answerQueries(*queries, answers, threads);
+            return answersChecksum(answers);
+        }};
+    }});
+    workloads.push_back({"lr6-4/maxPathWidthBinarySearch", queryText, "queries", [=] {
+        auto queries = makeQueries(count);
+        return PreparedWorkload{double(count), "", [=] {
+            vector<int64_t> answers(queries->size());
+            for (size_t i = 0; i < answers.size(); ++i) {
+                answers[i] = lr64::maxPathWidthBinarySearch(queries->n[i], queries->m[i], queries->t[i]);
+            }
+            return answersChecksum(answers);
+        }};
+    }});
+}
+
+// экранирование строки для json
+string jsonString(const string& text) {
+    string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result + "\"";
+}
+
+// запись результатов в json
+bool saveBenchmarkJson(const string& filename, const vector<WorkloadResult>& results,
+                       const BenchmarkOptions& options) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file) {
+        cerr << "ошибка при создании файла " << filename << endl;
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmark\": \"lr6 kernels\",\n  \"warmup\": %d,\n  \"repetitions\": %d,\n"
+                  "  \"scale\": %g,\n  \"threads\": %d,\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+            options.warmup, options.repetitions, options.scale, options.threadCount,
+            thread::hardware_concurrency());
+    for (size_t k = 0; k < results.size(); ++k) {
+        const WorkloadResult& r = results[k];
+        vector<double> sorted = r.seconds;
+        sort(sorted.begin(), sorted.end());
+        double mean = 0;
+        for (double s : sorted) mean += s;
+        mean /= max<size_t>(sorted.size(), 1);
+        double median = percentile(sorted, 50);
+        const SystemCounters& c = r.counters;
+        fprintf(file, "    {\"name\": %s, \"parameters\": %s, \"unit\": %s, \"items\": %.17g,\n",
+                jsonString(r.name).c_str(), jsonString(r.parameters).c_str(), jsonString(r.unit).c_str(), r.items);
+        fprintf(file, "     \"seconds\": {\"min\": %.9g, \"mean\": %.9g, \"p50\": %.9g, \"p90\": %.9g, "
+                      "\"p99\": %.9g, \"max\": %.9g},\n",
+                sorted.empty() ? 0 : sorted.front(), mean, median, percentile(sorted, 90), percentile(sorted, 99),
+                sorted.empty() ? 0 : sorted.back());
+        fprintf(file, "     \"items_per_second\": %.9g, \"checksum\": \"%016llx\", \"stable\": %s,\n",
+                r.items / max(median, 1e-12), (unsigned long long)r.checksum, r.stable ? "true" : "false");
+        fprintf(file, "     \"system\": {\"user_seconds\": %.6g, \"system_seconds\": %.6g, \"minor_faults\": %ld, "
+                      "\"major_faults\": %ld, \"voluntary_switches\": %ld, \"forced_switches\": %ld},\n",
+                c.userSeconds, c.systemSeconds, c.minorFaults, c.majorFaults, c.voluntarySwitches,
+                c.forcedSwitches);
+        if (r.hasHardware) {
+            const lr6profile::CounterValues& h = r.hardware;
+            fprintf(file, "     \"hardware\": {\"cycles\": %llu, \"instructions\": %llu, \"cache_misses\": %llu, "
+                          "\"ipc\": %.4g}}%s\n",
+                    (unsigned long long)h.cycles, (unsigned long long)h.instructions,
+                    (unsigned long long)h.cacheMisses, h.cycles ? double(h.instructions) / h.cycles : 0.0,
+                    k + 1 < results.size() ? "," : "");
+        } else {
+            fprintf(file, "     \"hardware\": null}%s\n", k + 1 < results.size() ? "," : "");
+        }
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = fclose(file) == 0;
+    if (!ok) cerr << "ошибка при записи файла " << filename << endl;
+    return ok;
+}
+
+// разбор аргументов командной строки
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--list") {
+            options.listOnly = true;
+        } else if (argument == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (argument == "--warmup" && hasValue) {
+            options.warmup = atoi(argv[++i]);
+        } else if (argument == "--repetitions" && hasValue) {
+            options.repetitions = atoi(argv[++i]);
+        } else if (argument == "--scale" && hasValue) {
+            options.scale = atof(argv[++i]);
+        } else if (argument == "--threads" && hasValue) {
+            options.threadCount = atoi(argv[++i]);
+        } else if (argument == "--json" && hasValue) {
+            options.jsonFile = argv[++i];
+        } else {
+            cerr << "неизвестный или неполный аргумент " << argument << endl;
+            return false;
+        }
+    }
+    if (options.warmup < 0 || options.repetitions < 1 || !(options.scale > 0) || options.threadCount < 0) {
+        cerr << "прогрев должен быть >= 0, повторы >= 1, масштаб > 0, потоки >= 0" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "использование: " << argv[0] << " [--filter подстрока] [--warmup n] [--repetitions n]"
+             << " [--scale k] [--threads n] [--json файл] [--list]" << endl;
+        return 1;
+    }
+
+    vector<Workload> workloads;
+    addMatrixWorkloads(workloads, options);
+    addCipherWorkloads(workloads, options);
+    addSolverWorkloads(workloads, options);
+    addWidthWorkloads(workloads, options);
+    // фильтр применяется до подготовки данных: невыбранные нагрузки ничего не генерируют
+    workloads.erase(remove_if(workloads.begin(), workloads.end(),
+                              [&](const Workload& w) { return w.name.find(options.filter) == string::npos; }),
+                    workloads.end());
+
+    if (options.listOnly) {
+        for (const Workload& workload : workloads) cout << workload.name << "\t" << workload.parameters << endl;
+        return 0;
+    }
+    if (workloads.empty()) {
+        cerr << "нет нагрузок, подходящих под фильтр " << options.filter << endl;
+        return 1;
+    }
+
+    cout << padded("нагрузка", -32) << padded("параметры", -34) << padded("p50, мс", 12)
+         << padded("p90, мс", 12) << padded("p99, мс", 12) << padded("элем./с", 14) << endl;
+    vector<WorkloadResult> results;
+    bool stable = true;
+    for (const Workload& workload : workloads) {
+        WorkloadResult result = measure(workload, options);
+        vector<double> sorted = result.seconds;
+        sort(sorted.begin(), sorted.end());
+        double median = percentile(sorted, 50);
+        cout << padded(result.name, -32) << padded(result.parameters, -34) << fixed
+             << setprecision(3) << setw(12) << median * 1e3 << setw(12) << percentile(sorted, 90) * 1e3
+             << setw(12) << percentile(sorted, 99) * 1e3 << scientific << setprecision(3) << setw(14)
+             << result.items / max(median, 1e-12) << (result.stable ? "" : "  КОНТРОЛЬНАЯ СУММА МЕНЯЕТСЯ!")
+             << endl;
+        cout.unsetf(ios::floatfield);
+        stable = stable && result.stable;
+        results.push_back(move(result));
+    }
+
+    if (!saveBenchmarkJson(options.jsonFile, results, options)) return 1;
+    cout << "результаты сохранены в файл: " << options.jsonFile << endl;
+    return stable ? 0 : 1;
+}
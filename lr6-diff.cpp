@@ -0,0 +1,509 @@
+// сверка реализаций на c++ и rust: одни и те же входные данные (генерируются по seed)
+// подаются обеим версиям каждой задачи, результаты сравниваются побитно (для вещественных
+// решений - с допуском), время ядер выводится рядом, чтобы выбрать более быструю реализацию
+//
+// сборка: g++ -std=c++17 -O2 -o lr6-diff lr6-diff.cpp
+// программы должны быть собраны заранее:
+//   g++ -std=c++17 -O2 -pthread -o lr6-N lr6-N.cpp            (N = 1..4)
+//   (cd lr6-1r && cargo build --release), (cd lr6-2r && cargo build --release)
+//   rustc -O lr6-3r.rs, rustc -O lr6-4r.rs
+// запуск: lr6-diff [--scale k] [--seed s] [--repetitions n] [--cpp-dir каталог]
+//                  [--rust-dir каталог] [--work каталог] [--json файл]
+//
+// каждая программа сама замеряет время своего ядра (без запуска процесса) и печатает его
+// строкой "... за X с" (lr6-4 - "решение X с" в поток ошибок). для lr6-2, lr6-3 и lr6-4
+// разбор входа в замер не входит; потоковый режим lr6-1 читает файл частями вперемешку
+// с анализом, поэтому для lr6-1 обе версии замеряют чтение, разбор и анализ вместе
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// параметры запуска
+struct DiffOptions {
+    double scale = 1.0;          // множитель размеров входных данных
+    uint64_t seed = 20240601;    // seed генерации входных данных
+    int repetitions = 3;         // запусков каждой версии (берется наименьшее время)
+    string cppDir = ".";         // каталог с lr6-1..lr6-4
+    string rustDir;              // каталог с lr6-1r..lr6-4r (пусто - расположение по умолчанию)
+    string workDir = "lr6-diff-work";
+    string jsonFile = "lr6-diff.json";
+};
+
+// способ сравнения результатов
+enum class Comparison {
+    Exact,      // стандартный вывод побайтно
+    OutputFile, // выходные файлы побайтно
+    Numbers     // числа стандартного вывода с допуском
+};
+
+// задача сверки: одна и та же работа для двух реализаций
+struct DiffTask {
+    string name;          // задача
+    string parameters;    // размеры входа
+    double items = 0;     // элементов входа (для пропускной способности)
+    string unit;          // единица элементов
+    string cppCommand;    // командная строка версии на c++
+    string rustCommand;   // командная строка версии на rust
+    string cppOutput;     // выходной файл c++ (для Comparison::OutputFile)
+    string rustOutput;    // выходной файл rust
+    string timeMarker;    // текст перед временем ядра в выводе программы
+    Comparison comparison = Comparison::Exact;
+    double tolerance = 0; // относительный допуск для Comparison::Numbers
+    bool timeLine = true; // первая строка стандартного вывода - время, она не сравнивается
+};
+
+// результат одной версии
+struct RunResult {
+    bool ok = false;        // процесс завершился успешно и время найдено
+    double kernelSeconds = 0; // наименьшее время ядра по запускам
+    double wallSeconds = 0;   // наименьшее время процесса целиком
+    string stdoutText;      // вывод последнего запуска
+    string stderrText;
+};
+
+// результат задачи
+struct TaskResult {
+    DiffTask task;
+    RunResult cpp, rust;
+    bool match = false;       // результаты совпали
+    double maxDeviation = 0;  // наибольшее относительное отклонение (для чисел)
+    string detail;            // пояснение при расхождении
+};
+
+// путь в одинарных кавычках для командной оболочки
+string shellQuoted(const string& text) {
+    string result = "'";
+    for (char c : text) {
+        if (c == '\'') result += "'\\''";
+        else result += c;
+    }
+    return result + "'";
+}
+
+// дополнение пробелами до width символов utf-8; отрицательная ширина - выравнивание влево
+string padded(const string& text, int width) {
+    int length = 0;
+    for (unsigned char c : text) length += (c & 0xC0) != 0x80;
+    string padding(size_t(max(0, abs(width) - length)), ' ');
+    return width < 0 ? text + padding : padding + text;
+}
+
+// содержимое файла целиком ("" при ошибке)
+string readFile(const string& filename) {
+    ifstream file(filename, ios::binary);
+    stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// текст без первой строки
+string withoutFirstLine(const string& text) {
+    size_t end = text.find('\n');
+    return end == string::npos ? string() : text.substr(end + 1);
+}
+
+// число после первого вхождения marker в text (время ядра); false, если не найдено
+bool findSeconds(const string& text, const string& marker, double& seconds) {
+    size_t position = text.find(marker);
+    if (position == string::npos) return false;
+    const char* begin = text.c_str() + position + marker.size();
+    char* end = nullptr;
+    seconds = strtod(begin, &end);
+    return end != begin;
+}
+
+// запуск команды repetitions раз с перенаправлением вывода в файлы
+RunResult runCommand(const string& command, const DiffTask& task, const string& prefix,
+                     const DiffOptions& options) {
+    RunResult result;
+    string outFile = options.workDir + "/" + prefix + ".stdout";
+    string errFile = options.workDir + "/" + prefix + ".stderr";
+    for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+        auto start = chrono::steady_clock::now();
+        int status = system((command + " > " + shellQuoted(outFile) + " 2> " + shellQuoted(errFile)).c_str());
+        double wall = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.stdoutText = readFile(outFile);
+        result.stderrText = readFile(errFile);
+        double kernel;
+        if (status != 0 || !findSeconds(result.stdoutText + result.stderrText, task.timeMarker, kernel)) {
+            result.ok = false;
+            return result;
+        }
+        result.kernelSeconds = repetition == 0 ? kernel : min(result.kernelSeconds, kernel);
+        result.wallSeconds = repetition == 0 ? wall : min(result.wallSeconds, wall);
+        result.ok = true;
+    }
+    return result;
+}
+
+// все числа текста
+vector<double> parseNumbers(const string& text) {
+    vector<double> numbers;
+    const char* p = text.c_str();
+    while (*p) {
+        char* end = nullptr;
+        double value = strtod(p, &end);
+        if (end == p) {
+            ++p;
+            continue;
+        }
+        numbers.push_back(value);
+        p = end;
+    }
+    return numbers;
+}
+
+// сравнение результатов двух версий
+void compareResults(TaskResult& result) {
+    const DiffTask& task = result.task;
+    if (task.comparison == Comparison::OutputFile) {
+        string a = readFile(task.cppOutput), b = readFile(task.rustOutput);
+        // пустые выходы совпадают всегда, но означают, что обработки не было
+        if (a.empty() && b.empty()) {
+            result.detail = "обе версии не записали выходной файл";
+            return;
+        }
+        result.match = a == b;
+        if (!result.match) {
+            size_t first = 0;
+            while (first < min(a.size(), b.size()) && a[first] == b[first]) ++first;
+            result.detail = "первое различие в байте " + to_string(first) + " (размеры " + to_string(a.size()) +
+                            " и " + to_string(b.size()) + ")";
+        }
+        return;
+    }
+    string a = result.cpp.stdoutText, b = result.rust.stdoutText;
+    if (task.timeLine) {
+        a = withoutFirstLine(a);
+        b = withoutFirstLine(b);
+    }
+    if (a.empty() && b.empty()) {
+        result.detail = "обе версии ничего не вывели";
+        return;
+    }
+    if (task.comparison == Comparison::Exact) {
+        result.match = a == b;
+        if (!result.match) {
+            size_t first = 0;
+            while (first < min(a.size(), b.size()) && a[first] == b[first]) ++first;
+            size_t line = count(a.begin(), a.begin() + first, '\n') + 1;
+            result.detail = "первое различие в строке " + to_string(line);
+        }
+        return;
+    }
+    vector<double> x = parseNumbers(a), y = parseNumbers(b);
+    if (x.size() != y.size() || x.empty()) {
+        result.detail = "разное число значений: " + to_string(x.size()) + " и " + to_string(y.size());
+        return;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+        double deviation = fabs(x[i] - y[i]) / max(1.0, fabs(x[i]));
+        if (!(deviation <= result.maxDeviation)) result.maxDeviation = deviation; // NaN тоже попадает сюда
+    }
+    result.match = result.maxDeviation <= task.tolerance;
+    if (!result.match) result.detail = "отклонение больше допуска " + to_string(task.tolerance);
+}
+
+// размер, умноженный на масштаб (не меньше minimum)
+int64_t scaled(double size, const DiffOptions& options, int64_t minimum = 1) {
+    return max<int64_t>(minimum, int64_t(llround(size * options.scale)));
+}
+
+// запись текста в файл
+bool writeFile(const string& filename, const string& text) {
+    ofstream file(filename, ios::binary);
+    file << text;
+    file.close();
+    if (!file) cerr << "ошибка при записи файла " << filename << endl;
+    return bool(file);
+}
+
+// 16 случайных байт в виде 32 шестнадцатеричных цифр
+string randomHexBlock(mt19937_64& generator) {
+    char text[33];
+    for (int i = 0; i < 16; ++i) snprintf(text + 2 * i, 3, "%02x", unsigned(generator() & 0xFF));
+    return string(text, 32);
+}
+
+// система с диагональным преобладанием в формате matrix market (array, по столбцам)
+bool writeSystem(const string& matrixFile, const string& vectorFile, int size, mt19937_64& generator) {
+    uniform_real_distribution<double> offDiagonal(-1.0, 1.0);
+    vector<double> matrix(size_t(size) * size);
+    for (int i = 0; i < size; ++i) {
+        double sum = 0;
+        for (int j = 0; j < size; ++j) {
+            if (i == j) continue;
+            matrix[size_t(i) * size + j] = offDiagonal(generator);
+            sum += fabs(matrix[size_t(i) * size + j]);
+        }
+        matrix[size_t(i) * size + i] = sum + 1.0;
+    }
+    string text = "%%MatrixMarket matrix array real general\n" + to_string(size) + " " + to_string(size) + "\n";
+    char number[32];
+    for (int j = 0; j < size; ++j) {
+        for (int i = 0; i < size; ++i) {
+            snprintf(number, sizeof(number), "%.17g\n", matrix[size_t(i) * size + j]);
+            text += number;
+        }
+    }
+    string vector = "%%MatrixMarket matrix array real general\n" + to_string(size) + " 1\n";
+    for (int i = 0; i < size; ++i) {
+        snprintf(number, sizeof(number), "%.17g\n", offDiagonal(generator) * 10);
+        vector += number;
+    }
+    return writeFile(matrixFile, text) && writeFile(vectorFile, vector);
+}
+
+// пути к программам: c++ - cppDir/lr6-N, rust - rustDir/lr6-Nr или расположение по умолчанию
+string cppProgram(const DiffOptions& options, int number) {
+    return shellQuoted(options.cppDir + "/lr6-" + to_string(number));
+}
+string rustProgram(const DiffOptions& options, int number) {
+    if (!options.rustDir.empty()) return shellQuoted(options.rustDir + "/lr6-" + to_string(number) + "r");
+    // lr6-1r и lr6-2r - проекты cargo, lr6-3r и lr6-4r собираются rustc в корне
+    if (number <= 2) {
+        string name = "lr6-" + to_string(number) + "r";
+        return shellQuoted(name + "/target/release/" + name);
+    }
+    return shellQuoted("./lr6-" + to_string(number) + "r");
+}
+
+// подготовка входных данных и команд всех задач
+bool prepareTasks(const DiffOptions& options, vector<DiffTask>& tasks) {
+    mt19937_64 generator(options.seed);
+    const string& dir = options.workDir;
+
+    // lr6-1: поиск серии и подсчет элементов на текстовой матрице
+    {
+        int64_t rows = scaled(2000, options), cols = scaled(500, options, 2);
+        uniform_int_distribution<int> value(-1000, 1000);
+        string text;
+        for (int64_t i = 0; i < rows; ++i) {
+            for (int64_t j = 0; j < cols; ++j) {
+                text += to_string(value(generator));
+                text += j + 1 < cols ? ' ' : '\n';
+            }
+        }
+        string file = dir + "/matrix.txt";
+        if (!writeFile(file, text)) return false;
+        DiffTask task;
+        task.name = "lr6-1 matrix";
+        task.parameters = to_string(rows) + "x" + to_string(cols) + " +read";
+        task.items = double(rows) * cols;
+        task.unit = "elements";
+        task.cppCommand = cppProgram(options, 1) + " --stream " + shellQuoted(file);
+        task.rustCommand = rustProgram(options, 1) + " --analyze " + shellQuoted(file);
+        task.timeMarker = " за ";
+        tasks.push_back(task);
+    }
+
+    // lr6-2: режим OFB
+    {
+        size_t bytes = size_t(scaled(4 << 20, options));
+        string data(bytes, '\0');
+        for (char& c : data) c = char(generator() & 0xFF);
+        string input = dir + "/ofb.in";
+        if (!writeFile(input, data)) return false;
+        string key = randomHexBlock(generator), iv = randomHexBlock(generator);
+        DiffTask task;
+        task.name = "lr6-2 ofb";
+        task.parameters = to_string(bytes) + " bytes";
+        task.items = double(bytes);
+        task.unit = "bytes";
+        task.cppOutput = dir + "/ofb.cpp.out";
+        task.rustOutput = dir + "/ofb.rust.out";
+        task.cppCommand = cppProgram(options, 2) + " --ofb " + key + " " + iv + " " + shellQuoted(input) + " " +
+                          shellQuoted(task.cppOutput);
+        task.rustCommand = rustProgram(options, 2) + " --ofb " + key + " " + iv + " " + shellQuoted(input) + " " +
+                           shellQuoted(task.rustOutput);
+        task.timeMarker = " за ";
+        task.comparison = Comparison::OutputFile;
+        tasks.push_back(task);
+    }
+
+    // lr6-3: прямой и итерационные методы; итерационные сравниваются с допуском порядка точности
+    const double epsilon = 1e-10;
+    for (string method : {"gauss", "jacobi", "seidel"}) {
+        int size = int(scaled(method == "gauss" ? 300 : 1000, options, 2));
+        string matrixFile = dir + "/" + method + ".A.mtx", vectorFile = dir + "/" + method + ".b.mtx";
+        if (!writeSystem(matrixFile, vectorFile, size, generator)) return false;
+        string arguments = " --solution " + shellQuoted(matrixFile) + " " + shellQuoted(vectorFile) + " " + method + " 1e-10 1000";
+        DiffTask task;
+        task.name = "lr6-3 " + method;
+        task.parameters = "n=" + to_string(size);
+        task.items = double(size) * size;
+        task.unit = "matrix elements";
+        task.cppCommand = cppProgram(options, 3) + arguments;
+        task.rustCommand = rustProgram(options, 3) + arguments;
+        task.timeMarker = "за ";
+        task.comparison = Comparison::Numbers;
+        task.tolerance = method == "gauss" ? 1e-12 : 10 * epsilon;
+        tasks.push_back(task);
+    }
+
+    // lr6-4: пакет запросов, часть из них некорректна
+    {
+        int64_t count = scaled(1000000, options);
+        string text;
+        for (int64_t i = 0; i < count; ++i) {
+            int64_t n = 1 + int64_t(generator() % 1000000), m = 1 + int64_t(generator() % 1000000);
+            int64_t t = int64_t(generator() % uint64_t(n * m + 1));
+            text += to_string(n) + " " + to_string(m) + " " + to_string(t) + "\n";
+        }
+        string file = dir + "/queries.txt";
+        if (!writeFile(file, text)) return false;
+        DiffTask task;
+        task.name = "lr6-4 batch";
+        task.parameters = to_string(count) + " queries";
+        task.items = double(count);
+        task.unit = "queries";
+        task.cppCommand = cppProgram(options, 4) + " --batch " + shellQuoted(file);
+        task.rustCommand = rustProgram(options, 4) + " --batch < " + shellQuoted(file);
+        task.timeMarker = "решение ";
+        task.timeLine = false; // время печатается в поток ошибок
+        tasks.push_back(task);
+    }
+    return true;
+}
+
+// запись результатов в json
+bool saveDiffJson(const string& filename, const vector<TaskResult>& results, const DiffOptions& options) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file) {
+        cerr << "ошибка при создании файла " << filename << endl;
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmark\": \"lr6 c++ vs rust\",\n  \"seed\": %llu,\n  \"scale\": %g,\n"
+                  "  \"repetitions\": %d,\n  \"results\": [\n",
+            (unsigned long long)options.seed, options.scale, options.repetitions);
+    for (size_t k = 0; k < results.size(); ++k) {
+        const TaskResult& r = results[k];
+        auto engine = [&](const char* name, const RunResult& run) {
+            if (!run.ok) {
+                fprintf(file, "\"%s\": null", name);
+                return;
+            }
+            fprintf(file, "\"%s\": {\"kernel_seconds\": %.9g, \"wall_seconds\": %.9g, \"items_per_second\": %.9g}",
+                    name, run.kernelSeconds, run.wallSeconds, r.task.items / max(run.kernelSeconds, 1e-12));
+        };
+        fprintf(file, "    {\"task\": \"%s\", \"parameters\": \"%s\", \"unit\": \"%s\", \"items\": %.17g, ",
+                r.task.name.c_str(), r.task.parameters.c_str(), r.task.unit.c_str(), r.task.items);
+        engine("cpp", r.cpp);
+        fprintf(file, ", ");
+        engine("rust", r.rust);
+        fprintf(file, ", \"match\": %s, \"max_deviation\": %.3g}%s\n", r.match ? "true" : "false",
+                r.maxDeviation, k + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = fclose(file) == 0;
+    if (!ok) cerr << "ошибка при записи файла " << filename << endl;
+    return ok;
+}
+
+// разбор аргументов командной строки
+bool parseOptions(int argc, char* argv[], DiffOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "у аргумента " << argument << " нет значения" << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (argument == "--scale") options.scale = atof(value.c_str());
+        else if (argument == "--seed") options.seed = strtoull(value.c_str(), nullptr, 10);
+        else if (argument == "--repetitions") options.repetitions = atoi(value.c_str());
+        else if (argument == "--cpp-dir") options.cppDir = value;
+        else if (argument == "--rust-dir") options.rustDir = value;
+        else if (argument == "--work") options.workDir = value;
+        else if (argument == "--json") options.jsonFile = value;
+        else {
+            cerr << "неизвестный аргумент " << argument << endl;
+            return false;
+        }
+    }
+    if (!(options.scale > 0) || options.repetitions < 1) {
+        cerr << "масштаб должен быть > 0, повторы >= 1" << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    DiffOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "использование: " << argv[0] << " [--scale k] [--seed s] [--repetitions n] [--cpp-dir каталог]"
+             << " [--rust-dir каталог] [--work каталог] [--json файл]" << endl;
+        return 1;
+    }
+    mkdir(options.workDir.c_str(), 0755);
+
+    vector<DiffTask> tasks;
+    if (!prepareTasks(options, tasks)) return 1;
+
+    cout << padded("задача", -14) << padded("параметры", -18) << padded("c++, с", 12) << padded("rust, с", 12)
+         << padded("c++ эл./с", 12) << padded("rust эл./с", 12) << padded("быстрее", 12) << "  результат" << endl;
+    vector<TaskResult> results;
+    bool allMatch = true;
+    for (const DiffTask& task : tasks) {
+        TaskResult result;
+        result.task = task;
+        string prefix = task.name;
+        replace(prefix.begin(), prefix.end(), ' ', '-');
+        result.cpp = runCommand(task.cppCommand, task, prefix + ".cpp", options);
+        result.rust = runCommand(task.rustCommand, task, prefix + ".rust", options);
+        if (result.cpp.ok && result.rust.ok) compareResults(result);
+
+        cout << left << setw(14) << task.name << setw(18) << task.parameters << right << scientific
+             << setprecision(3);
+        for (const RunResult* run : {&result.cpp, &result.rust}) {
+            if (run->ok) cout << setw(12) << run->kernelSeconds;
+            else cout << setw(12) << "-";
+        }
+        for (const RunResult* run : {&result.cpp, &result.rust}) {
+            if (run->ok) cout << setw(12) << task.items / max(run->kernelSeconds, 1e-12);
+            else cout << setw(12) << "-";
+        }
+        if (result.cpp.ok && result.rust.ok) {
+            bool cppFaster = result.cpp.kernelSeconds <= result.rust.kernelSeconds;
+            double ratio = cppFaster ? result.rust.kernelSeconds / max(result.cpp.kernelSeconds, 1e-12)
+                                     : result.cpp.kernelSeconds / max(result.rust.kernelSeconds, 1e-12);
+            ostringstream faster;
+            faster << (cppFaster ? "c++ " : "rust ") << fixed << setprecision(1) << ratio << "x";
+            cout << setw(12) << faster.str();
+        } else {
+            cout << setw(12) << "-";
+        }
+        cout.unsetf(ios::floatfield);
+        if (!result.cpp.ok || !result.rust.ok) {
+            cout << "  ОШИБКА ЗАПУСКА " << (result.cpp.ok ? "rust" : "c++") << ": "
+                 << (result.cpp.ok ? task.rustCommand : task.cppCommand) << endl;
+        } else if (result.match) {
+            cout << "  совпадает";
+            if (task.comparison == Comparison::Numbers) cout << " (отклонение " << setprecision(2) << result.maxDeviation << ")";
+            cout << endl;
+        } else {
+            cout << "  РАСХОЖДЕНИЕ: " << result.detail << endl;
+        }
+        allMatch = allMatch && result.cpp.ok && result.rust.ok && result.match;
+        results.push_back(result);
+    }
+
+    if (!saveDiffJson(options.jsonFile, results, options)) return 1;
+    cout << "результаты сохранены в файл: " << options.jsonFile << endl;
+    return allMatch ? 0 : 1;
+}
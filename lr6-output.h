@@ -0,0 +1,118 @@
+// общий слой вывода для программ лабораторной работы 6:
+// числа форматируются через std::to_chars в большой буфер, который
+// сбрасывается в поток крупными частями (без сброса после каждой строки)
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class OutputBuffer {
+public:
+    // out - поток назначения, capacity - размер буфера (по умолчанию 1 мб)
+    explicit OutputBuffer(std::ostream& out, size_t capacity = size_t(1) << 20)
+        : out(out), buffer(capacity) {}
+
+    // остаток буфера записывается при уничтожении
+    ~OutputBuffer() { flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    // один символ
+    void put(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+
+    // строка символов
+    void write(const char* text, size_t length) {
+        if (length > buffer.size() - used) {
+            flush();
+            // большие блоки пишем напрямую, минуя буфер
+            if (length >= buffer.size()) {
+                out.write(text, std::streamsize(length));
+                return;
+            }
+        }
+        memcpy(buffer.data() + used, text, length);
+        used += length;
+    }
+    void write(const char* text) { write(text, strlen(text)); }
+    void write(const std::string& text) { write(text.data(), text.size()); }
+
+    // двоичные данные как есть (для двоичных дампов)
+    void writeRaw(const void* data, size_t bytes) { write(static_cast<const char*>(data), bytes); }
+
+    // целое число, выровненное вправо по ширине width
+    template <typename Integer>
+    void writeInteger(Integer value, int width = 0) {
+        char number[24];
+        auto result = std::to_chars(number, number + sizeof(number), value);
+        writePadded(number, result.ptr, width);
+    }
+
+    // вещественное число в формате format с точностью precision, выровненное вправо по ширине width
+    void writeDouble(double value, std::chars_format format, int precision, int width = 0) {
+        // фиксированная запись 1e308 занимает больше 300 символов
+        if (scratch.size() < size_t(precision) + 400) scratch.resize(size_t(precision) + 400);
+        auto result = std::to_chars(scratch.data(), scratch.data() + scratch.size(), value, format, precision);
+        writePadded(scratch.data(), result.ptr, width);
+    }
+
+    // вещественное число в том же виде, что дал бы вывод в поток style
+    // (учитываются fixed/scientific и точность, как у cout << setw(width) << value)
+    void writeDouble(double value, const std::ios_base& style, int width = 0) {
+        std::ios_base::fmtflags field = style.flags() & std::ios_base::floatfield;
+        std::chars_format format = field == std::ios_base::fixed        ? std::chars_format::fixed
+                                   : field == std::ios_base::scientific ? std::chars_format::scientific
+                                   : field == (std::ios_base::fixed | std::ios_base::scientific)
+                                       ? std::chars_format::hex
+                                       : std::chars_format::general;
+        int precision = int(style.precision());
+        if (format == std::chars_format::hex && std::isfinite(value)) {
+            // to_chars не пишет префикс 0x, который выводит поток
+            char number[64];
+            bool negative = std::signbit(value);
+            char* digits = number + (negative ? 1 : 0);
+            auto result = std::to_chars(digits + 2, number + sizeof(number), std::fabs(value), format);
+            if (negative) number[0] = '-';
+            digits[0] = '0';
+            digits[1] = 'x';
+            writePadded(number, result.ptr, width);
+            return;
+        }
+        writeDouble(value, format, precision, width);
+    }
+
+    // запись накопленного в поток
+    void flush() {
+        if (used) out.write(buffer.data(), std::streamsize(used));
+        used = 0;
+    }
+
+private:
+    // запись [begin, end) с дополнением пробелами слева до ширины width
+    void writePadded(const char* begin, const char* end, int width) {
+        for (int pad = width - int(end - begin); pad > 0; --pad) put(' ');
+        write(begin, size_t(end - begin));
+    }
+
+    std::ostream& out;         // поток назначения
+    std::vector<char> buffer;  // буфер вывода
+    size_t used = 0;           // занято в буфере
+    std::vector<char> scratch; // место для форматирования длинных чисел
+};
+
+// заголовок двоичного дампа матрицы: сигнатура из 8 байт, затем rows и cols (uint64);
+// после него идут элементы матрицы по строкам
+inline void writeBinaryMatrixHeader(OutputBuffer& out, const char (&magic)[8], uint64_t rows, uint64_t cols) {
+    out.write(magic, sizeof(magic));
+    out.writeRaw(&rows, sizeof(rows));
+    out.writeRaw(&cols, sizeof(cols));
+}
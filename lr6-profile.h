@@ -0,0 +1,392 @@
+// инструментирование горячих участков программ лабораторной работы 6
+//
+// LR6_PROFILE_ZONE("имя") в начале блока замеряет время блока (RAII-зона).
+// Зоны вкладываются друг в друга: каждый поток строит свое дерево вызовов
+// без блокировок, при завершении потока дерево сливается в общее. Код, запускающий
+// потоки, запоминает свои открытые зоны (LR6_PROFILE_PARENT), а поток-исполнитель
+// прикрепляется к ним (LR6_PROFILE_ATTACH): его зоны попадают в дерево под зоной,
+// запустившей потоки, с пометкой "в других потоках". При выходе из программы
+// в stderr печатается сводка в виде дерева (общее и собственное время, доля от
+// суммарного времени потоков, число вызовов). Если задана переменная окружения
+// LR6_PROFILE_COUNTERS=1, для зон дополнительно читаются аппаратные счетчики
+// perf_event_open: такты, инструкции и промахи кэша (это несколько системных
+// вызовов на зону).
+//
+// Инструментирование включается ключом компиляции -DLR6_PROFILE; без него
+// LR6_PROFILE_ZONE раскрывается в пустой оператор и ничего не стоит.
+// Класс HardwareCounters доступен всегда (им пользуется стенд lr6-bench).
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lr6profile {
+
+// значения аппаратных счетчиков
+struct CounterValues {
+    uint64_t cycles = 0;       // такты процессора
+    uint64_t instructions = 0; // выполненные инструкции
+    uint64_t cacheMisses = 0;  // промахи последнего уровня кэша
+
+    CounterValues& operator+=(const CounterValues& other) {
+        cycles += other.cycles;
+        instructions += other.instructions;
+        cacheMisses += other.cacheMisses;
+        return *this;
+    }
+};
+
+inline CounterValues operator-(const CounterValues& after, const CounterValues& before) {
+    CounterValues delta;
+    delta.cycles = after.cycles - before.cycles;
+    delta.instructions = after.instructions - before.instructions;
+    delta.cacheMisses = after.cacheMisses - before.cacheMisses;
+    return delta;
+}
+
+// аппаратные счетчики вызывающего потока (только пользовательский режим);
+// includeNewThreads - учитывать и потоки, созданные после открытия счетчиков
+// (их значения добавляются, когда поток завершается)
+class HardwareCounters {
+public:
+    explicit HardwareCounters(bool includeNewThreads = false) {
+#if defined(__linux__)
+        const uint64_t events[3] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+        for (int i = 0; i < 3; ++i) {
+            perf_event_attr attributes;
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = events[i];
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.inherit = includeNewThreads ? 1 : 0;
+            descriptors[i] = int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+#else
+        (void)includeNewThreads;
+#endif
+    }
+
+    ~HardwareCounters() {
+#if defined(__linux__)
+        for (int descriptor : descriptors) {
+            if (descriptor >= 0) close(descriptor);
+        }
+#endif
+    }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    // удалось ли открыть счетчик тактов (без него остальные не имеют смысла)
+    bool available() const { return descriptors[0] >= 0; }
+
+    // текущие значения; недоступные счетчики читаются как 0
+    CounterValues read() const {
+        uint64_t values[3] = {0, 0, 0};
+#if defined(__linux__)
+        for (int i = 0; i < 3; ++i) {
+            if (descriptors[i] >= 0 && ::read(descriptors[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+                values[i] = 0;
+            }
+        }
+#endif
+        CounterValues result;
+        result.cycles = values[0];
+        result.instructions = values[1];
+        result.cacheMisses = values[2];
+        return result;
+    }
+
+private:
+    int descriptors[3] = {-1, -1, -1}; // такты, инструкции, промахи кэша
+};
+
+// узел дерева вызовов: зона в контексте своих родителей
+struct ZoneNode {
+    int zone = -1;            // номер зоны (-1 - корень)
+    int parent = -1;          // индекс родителя в дереве
+    bool parallel = false;    // зона открыта в потоке-исполнителе родителя, а не в его потоке
+    uint64_t calls = 0;       // число входов
+    uint64_t nanoseconds = 0; // суммарное время с вложенными зонами
+    CounterValues counters;   // счетчики с вложенными зонами
+    std::vector<int> children;
+};
+
+// дерево вызовов; узел 0 - корень
+struct CallTree {
+    std::vector<ZoneNode> nodes = std::vector<ZoneNode>(1);
+
+    // дочерний узел parent для зоны zone (создается при первом входе)
+    int child(int parent, int zone, bool parallel = false) {
+        for (int index : nodes[parent].children) {
+            if (nodes[index].zone == zone && nodes[index].parallel == parallel) return index;
+        }
+        ZoneNode node;
+        node.zone = zone;
+        node.parent = parent;
+        node.parallel = parallel;
+        nodes.push_back(node);
+        int index = int(nodes.size()) - 1;
+        nodes[parent].children.push_back(index);
+        return index;
+    }
+
+    // добавление поддерева other[from] к узлу to
+    void merge(const CallTree& other, int from, int to) {
+        for (int index : other.nodes[from].children) {
+            const ZoneNode& source = other.nodes[index];
+            int target = child(to, source.zone, source.parallel);
+            nodes[target].calls += source.calls;
+            nodes[target].nanoseconds += source.nanoseconds;
+            nodes[target].counters += source.counters;
+            merge(other, index, target);
+        }
+    }
+};
+
+// общие данные: имена зон и слитое дерево завершившихся потоков
+class Registry {
+public:
+    ~Registry() { report(); }
+
+    // номер зоны по имени (вызывается один раз на место в коде)
+    int registerZone(const char* name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        names.push_back(name);
+        return int(names.size()) - 1;
+    }
+
+    // слияние дерева завершившегося потока
+    void mergeThread(const CallTree& tree) {
+        std::lock_guard<std::mutex> lock(mutex);
+        merged.merge(tree, 0, 0);
+    }
+
+    // читать ли аппаратные счетчики в зонах
+    bool countersRequested() const { return requestCounters; }
+
+    // хотя бы один поток открыл счетчики
+    void markCountersOpened() { countersOpened = true; }
+
+    // сводка по всем завершившимся потокам в виде дерева
+    void report() {
+        std::lock_guard<std::mutex> lock(mutex);
+        // суммарное время потоков: зоны верхнего уровня и зоны, открытые потоками-исполнителями
+        // (время каждого потока учитывается один раз, поэтому собственные времена дают 100%)
+        uint64_t total = 0;
+        for (int index : merged.nodes[0].children) total += merged.nodes[index].nanoseconds;
+        for (const ZoneNode& node : merged.nodes) {
+            if (node.parallel) total += node.nanoseconds;
+        }
+        if (total == 0) return;
+        fprintf(stderr, "\nпрофиль (время всех потоков, доля от суммарного времени потоков):\n");
+        if (requestCounters && !countersOpened) fprintf(stderr, "аппаратные счетчики недоступны\n");
+        fprintf(stderr, "%s%s%s%s%s", padded("зона", -56).c_str(), padded("вызовы", 11).c_str(),
+                padded("всего, мс", 13).c_str(), padded("свое, мс", 13).c_str(), padded("доля", 8).c_str());
+        if (countersOpened) {
+            fprintf(stderr, "%s%s%s", padded("такты", 15).c_str(), padded("IPC", 7).c_str(),
+                    padded("промахи", 13).c_str());
+        }
+        fprintf(stderr, "\n");
+        printNode(0, 0, total);
+    }
+
+private:
+    // дополнение пробелами до width символов (имена зон в utf-8, считаются символы, а не байты);
+    // отрицательная ширина - выравнивание влево
+    static std::string padded(const std::string& text, int width) {
+        int length = 0;
+        for (unsigned char c : text) length += (c & 0xC0) != 0x80;
+        std::string padding(size_t(std::max(0, std::abs(width) - length)), ' ');
+        return width < 0 ? text + padding : padding + text;
+    }
+
+    void printNode(int index, int depth, uint64_t total) {
+        std::vector<int> children = merged.nodes[index].children;
+        // самые дорогие ветви первыми
+        std::sort(children.begin(), children.end(), [&](int a, int b) {
+            return merged.nodes[a].nanoseconds > merged.nodes[b].nanoseconds;
+        });
+        for (int child : children) {
+            const ZoneNode& node = merged.nodes[child];
+            // собственное время - без вложенных зон того же потока (исполнители работали параллельно)
+            uint64_t nested = 0;
+            for (int grandchild : node.children) {
+                if (!merged.nodes[grandchild].parallel) nested += merged.nodes[grandchild].nanoseconds;
+            }
+            std::string label = std::string(size_t(depth) * 2, ' ') + names[size_t(node.zone)];
+            if (node.parallel) label += " (в других потоках)";
+            fprintf(stderr, "%s %10llu %12.3f %12.3f %6.1f%%", padded(label, -56).c_str(), (unsigned long long)node.calls,
+                    node.nanoseconds * 1e-6, (node.nanoseconds - std::min(nested, node.nanoseconds)) * 1e-6,
+                    100.0 * node.nanoseconds / total);
+            if (countersOpened) {
+                fprintf(stderr, " %14llu %6.2f %12llu", (unsigned long long)node.counters.cycles,
+                        node.counters.cycles ? double(node.counters.instructions) / node.counters.cycles : 0.0,
+                        (unsigned long long)node.counters.cacheMisses);
+            }
+            fprintf(stderr, "\n");
+            printNode(child, depth + 1, total);
+        }
+    }
+
+    std::mutex mutex;
+    std::vector<const char*> names; // имена зон по номерам
+    CallTree merged;                // деревья завершившихся потоков
+    std::atomic<bool> countersOpened{false}; // хотя бы один поток открыл счетчики
+    bool requestCounters = getenv("LR6_PROFILE_COUNTERS") && strcmp(getenv("LR6_PROFILE_COUNTERS"), "1") == 0;
+};
+
+// единственный экземпляр; создается до первого потока с зонами и поэтому разрушается после них
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+inline int registerZone(const char* name) { return registry().registerZone(name); }
+
+// данные одного потока: пишет только сам поток, поэтому блокировки не нужны
+struct ThreadProfile {
+    ThreadProfile() : shared(registry()) {
+        if (shared.countersRequested()) {
+            counters.reset(new HardwareCounters());
+            if (counters->available()) {
+                shared.markCountersOpened();
+            } else {
+                counters.reset();
+            }
+        }
+    }
+    ~ThreadProfile() { shared.mergeThread(tree); }
+
+    Registry& shared;
+    CallTree tree;
+    int current = 0;                            // узел открытой зоны
+    int attachedAt = -1;                        // узел, к которому прикреплен поток-исполнитель
+    std::unique_ptr<HardwareCounters> counters; // счетчики потока, если доступны
+};
+
+inline ThreadProfile& threadProfile() {
+    thread_local ThreadProfile profile;
+    return profile;
+}
+
+// открытые зоны потока от внешней к внутренней: место в дереве, под которым
+// потоки-исполнители показывают свои зоны
+struct ZonePath {
+    std::thread::id owner;                  // поток, в котором зоны открыты
+    std::vector<std::pair<int, bool>> zones; // номер зоны и признак parallel ее узла
+};
+
+// открытые зоны вызывающего потока
+inline ZonePath currentPath() {
+    ThreadProfile& profile = threadProfile();
+    ZonePath path;
+    path.owner = std::this_thread::get_id();
+    for (int index = profile.current; index > 0; index = profile.tree.nodes[size_t(index)].parent) {
+        const ZoneNode& node = profile.tree.nodes[size_t(index)];
+        path.zones.emplace_back(node.zone, node.parallel);
+    }
+    std::reverse(path.zones.begin(), path.zones.end());
+    return path;
+}
+
+// RAII-прикрепление потока-исполнителя к зонам запустившего его кода: узлы пути создаются
+// в дереве потока без времени и вызовов и при слиянии совпадают с узлами запустившего потока;
+// в самом запустившем потоке ничего не делает
+class AttachedZones {
+public:
+    explicit AttachedZones(const ZonePath& path) : profile(threadProfile()) {
+        if (path.owner == std::this_thread::get_id()) return;
+        active = true;
+        int node = 0;
+        for (const auto& zone : path.zones) node = profile.tree.child(node, zone.first, zone.second);
+        savedCurrent = profile.current;
+        savedAttachedAt = profile.attachedAt;
+        profile.current = node;
+        profile.attachedAt = node;
+    }
+
+    ~AttachedZones() {
+        if (!active) return;
+        profile.current = savedCurrent;
+        profile.attachedAt = savedAttachedAt;
+    }
+
+    AttachedZones(const AttachedZones&) = delete;
+    AttachedZones& operator=(const AttachedZones&) = delete;
+
+private:
+    ThreadProfile& profile;
+    bool active = false;
+    int savedCurrent = 0;
+    int savedAttachedAt = -1;
+};
+
+// RAII-зона: вход в конструкторе, выход в деструкторе
+class ScopedZone {
+public:
+    explicit ScopedZone(int zone) : profile(threadProfile()) {
+        parent = profile.current;
+        // первая зона потока-исполнителя - параллельная часть зоны, запустившей потоки
+        node = profile.tree.child(parent, zone, parent == profile.attachedAt);
+        profile.current = node;
+        if (profile.counters) startCounters = profile.counters->read();
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedZone() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        ZoneNode& data = profile.tree.nodes[size_t(node)];
+        data.calls++;
+        data.nanoseconds += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        if (profile.counters) data.counters += profile.counters->read() - startCounters;
+        profile.current = parent;
+    }
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    ThreadProfile& profile;
+    int parent = 0;
+    int node = 0;
+    CounterValues startCounters;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace lr6profile
+
+#define LR6_PROFILE_CONCAT_IMPL(a, b) a##b
+#define LR6_PROFILE_CONCAT(a, b) LR6_PROFILE_CONCAT_IMPL(a, b)
+
+// LR6_PROFILE_PARENT(path) перед запуском потоков запоминает открытые зоны в переменной path,
+// LR6_PROFILE_ATTACH(path) в начале потока-исполнителя прикрепляет его зоны к ним
+#if defined(LR6_PROFILE)
+#define LR6_PROFILE_ZONE(name)                                                                             \
+    static const int LR6_PROFILE_CONCAT(lr6ProfileZone, __LINE__) = ::lr6profile::registerZone(name);     \
+    ::lr6profile::ScopedZone LR6_PROFILE_CONCAT(lr6ProfileScope, __LINE__)(LR6_PROFILE_CONCAT(lr6ProfileZone, __LINE__))
+#define LR6_PROFILE_PARENT(path) const ::lr6profile::ZonePath path = ::lr6profile::currentPath()
+#define LR6_PROFILE_ATTACH(path) ::lr6profile::AttachedZones LR6_PROFILE_CONCAT(lr6ProfileAttach, __LINE__)(path)
+#else
+#define LR6_PROFILE_ZONE(name) static_cast<void>(0)
+#define LR6_PROFILE_PARENT(path) static_cast<void>(0)
+#define LR6_PROFILE_ATTACH(path) static_cast<void>(0)
+#endif